@@ -0,0 +1,165 @@
+/**
+ * @file attacks.c
+ * @brief This file contains the precomputed attack tables: knight, king and pawn attacks
+ * per square, and magic bitboard lookups for the sliding pieces.
+ */
+
+#include "init.h"
+#include "attacks.h"
+
+unsigned long long knightAttacks[64];
+unsigned long long kingAttacks[64];
+unsigned long long pawnAttacks[2][64];
+Magic bishopMagics[64];
+Magic rookMagics[64];
+unsigned long long betweenMasks[64][64];
+unsigned long long lineMasks[64][64];
+
+// Attack sets of every square and relevant occupancy (5248 bishop and 102400 rook entries)
+static unsigned long long bishopTable[5248];
+static unsigned long long rookTable[102400];
+
+// Square steps as (file, rank) deltas
+static const int KNIGHT_DELTAS[8][2] = {{1, 2}, {2, 1}, {2, -1}, {1, -2}, {-1, -2}, {-2, -1}, {-2, 1}, {-1, 2}};
+static const int KING_DELTAS[8][2] = {{0, 1}, {1, 1}, {1, 0}, {1, -1}, {0, -1}, {-1, -1}, {-1, 0}, {-1, 1}};
+static const int BISHOP_DELTAS[4][2] = {{1, 1}, {1, -1}, {-1, -1}, {-1, 1}};
+static const int ROOK_DELTAS[4][2] = {{0, 1}, {1, 0}, {0, -1}, {-1, 0}};
+
+// Multipliers mapping every relevant occupancy of a square to a distinct table slot
+// (found offline for the a8 = 0 square order, shift = 64 - bits of the mask).
+static const unsigned long long BISHOP_MAGICS[64] = {
+    0x10102002004a1420ULL, 0x8020040400584008ULL, 0x10510800811201c8ULL, 0x5204042080000088ULL,
+    0x2204106880000002ULL, 0x1401042004000000ULL, 0x0400880410042004ULL, 0x0028208200a02020ULL,
+    0x1500241990010e00ULL, 0x8001200182020a40ULL, 0x40004101030b0000ULL, 0x8002041042000100ULL,
+    0x4010011041020038ULL, 0x0000010421044000ULL, 0x1500210808020a00ULL, 0x8000088400880520ULL,
+    0x0405004010040100ULL, 0x1005823210040108ULL, 0x2708008102040011ULL, 0x4048200404009100ULL,
+    0x0018104101400024ULL, 0x0003000601190101ULL, 0x8004803108491000ULL, 0x8014241200820800ULL,
+    0x0006e080100c3040ULL, 0x0501044a11041800ULL, 0x9020300008004045ULL, 0x0894080000220040ULL,
+    0x1001010083104000ULL, 0x5004030040900080ULL, 0x000400422c012400ULL, 0x0002128698404812ULL,
+    0x1010108404900440ULL, 0x0928021182084100ULL, 0x2006080409020024ULL, 0x1010202020180080ULL,
+    0xa010008200202200ULL, 0x2098015100019004ULL, 0x0002041440810811ULL, 0x802a02020000b098ULL,
+    0x0009015090004060ULL, 0x4000821082081001ULL, 0x0100210040420800ULL, 0x0800004010488a00ULL,
+    0x2000081104004040ULL, 0x4c8e029015000082ULL, 0x0420340322224842ULL, 0x1298260043400210ULL,
+    0x0000822802400008ULL, 0x00008a0101600000ULL, 0x3040003412080021ULL, 0x3040290220884800ULL,
+    0x4a1500401041004aULL, 0x8010200282020781ULL, 0x0020203142209091ULL, 0x0070300600902110ULL,
+    0x0040808800b62048ULL, 0x0000810400c44420ULL, 0x00080400440c0441ULL, 0x8340080020840411ULL,
+    0x0000000104208200ULL, 0x0000800810d00080ULL, 0x0400530411080200ULL, 0x4040702400932244ULL
+};
+
+static const unsigned long long ROOK_MAGICS[64] = {
+    0x1080004008801020ULL, 0x0840092002c03000ULL, 0x1900200010400900ULL, 0x0880100008000480ULL,
+    0x4200100420080200ULL, 0x8100020100080400ULL, 0x0200040110886200ULL, 0x0200008040220411ULL,
+    0x0404800084400220ULL, 0x0000401000402000ULL, 0x0086001081220440ULL, 0x0408800800100280ULL,
+    0x000a001201040820ULL, 0x8848800200840080ULL, 0x4001000100040200ULL, 0x0442000102105084ULL,
+    0x9080010020804100ULL, 0x0040404000201009ULL, 0x0000808010002009ULL, 0x2200090021d00100ULL,
+    0x0008008008040080ULL, 0x0004004002010040ULL, 0x0011040008015042ULL, 0x00000a0001768104ULL,
+    0x0000800080204009ULL, 0x2010004140002001ULL, 0x9800200280100080ULL, 0x1000100080080080ULL,
+    0x0442000a00049020ULL, 0x2100040080020080ULL, 0x0800120400900148ULL, 0x0010040a00128541ULL,
+    0x2800804000800030ULL, 0x1010002000400041ULL, 0x4000200011004100ULL, 0x0610008410800800ULL,
+    0x0400802402800800ULL, 0xc100020080800400ULL, 0x0002000802000401ULL, 0x0182085882000401ULL,
+    0x0220204000808000ULL, 0x2860100040024022ULL, 0x0001002004110040ULL, 0x99101042000a0020ULL,
+    0x0004080004008080ULL, 0x0010040002008080ULL, 0x2012004881020004ULL, 0x8300842444820011ULL,
+    0x0088403882010200ULL, 0x0820400080210100ULL, 0x0110910040a00300ULL, 0x0801100280080480ULL,
+    0x0242009008200600ULL, 0x1002000489500200ULL, 0x0040800200010080ULL, 0x0091800041000080ULL,
+    0x0000209300488001ULL, 0x04c1002414824001ULL, 0x020020000b001041ULL, 0x7000100004200901ULL,
+    0x8002002004100802ULL, 0x30010002084c0007ULL, 0x0888221800813004ULL, 0x4000002840840112ULL
+};
+
+static int onBoard(int file, int rank) {
+    return file >= 0 && file <= 7 && rank >= 0 && rank <= 7;
+}
+
+/*
+@brief: walks every direction from a square, one step only or (for sliders) until the
+edge of the board or the first occupied square, which is included in the result.
+Only used to build the tables.
+*/
+static unsigned long long rayTargets(int square, unsigned long long occupancy, const int deltas[][2], int count, int slide) {
+    unsigned long long targets = 0ULL;
+    for (int d = 0; d < count; d++) {
+        int file = FILE_OF(square), rank = RANK_OF(square);
+        while (1) {
+            file += deltas[d][0];
+            rank += deltas[d][1];
+            if (!onBoard(file, rank)) break;
+            int target = (7 - rank) * 8 + file;
+            SET_BIT(targets, target);
+            if (!slide || IS_BIT_SET(occupancy, target)) break;
+        }
+    }
+    return targets;
+}
+
+// @brief: squares whose occupancy matters to a slider, i.e. its rays without the board edge.
+static unsigned long long relevantMask(int square, const int deltas[][2]) {
+    unsigned long long mask = 0ULL;
+    for (int d = 0; d < 4; d++) {
+        int file = FILE_OF(square) + deltas[d][0], rank = RANK_OF(square) + deltas[d][1];
+        while (onBoard(file + deltas[d][0], rank + deltas[d][1])) {
+            SET_BIT(mask, (7 - rank) * 8 + file);
+            file += deltas[d][0];
+            rank += deltas[d][1];
+        }
+    }
+    return mask;
+}
+
+// @brief: fills the magic entries of one slider and its attack sets for every occupancy subset.
+static void initSlider(Magic magics[64], unsigned long long *table, const unsigned long long numbers[64], const int deltas[][2]) {
+    unsigned long long *next = table;
+    for (int square = 0; square < 64; square++) {
+        Magic *entry = &magics[square];
+        entry->mask = relevantMask(square, deltas);
+        entry->magic = numbers[square];
+        entry->shift = 64 - __builtin_popcountll(entry->mask);
+        entry->attacks = next;
+
+        // Enumerate the subsets of the mask (Carry-Rippler).
+        unsigned long long subset = 0ULL;
+        do {
+            entry->attacks[magicIndex(entry, subset)] = rayTargets(square, subset, deltas, 4, 1);
+            subset = (subset - entry->mask) & entry->mask;
+        } while (subset);
+
+        next += 1ULL << (64 - entry->shift);
+    }
+}
+
+void initAttacks(void) {
+    static int initialized = 0;
+    if (initialized) return;
+
+    for (int square = 0; square < 64; square++) {
+        knightAttacks[square] = rayTargets(square, 0ULL, KNIGHT_DELTAS, 8, 0);
+        kingAttacks[square] = rayTargets(square, 0ULL, KING_DELTAS, 8, 0);
+
+        // White pawns capture towards rank 8 (square 0), black ones towards rank 1.
+        int file = FILE_OF(square), rank = RANK_OF(square);
+        pawnAttacks[WHITE][square] = pawnAttacks[BLACK][square] = 0ULL;
+        for (int side = -1; side <= 1; side += 2) {
+            if (onBoard(file + side, rank + 1)) SET_BIT(pawnAttacks[WHITE][square], (6 - rank) * 8 + file + side);
+            if (onBoard(file + side, rank - 1)) SET_BIT(pawnAttacks[BLACK][square], (8 - rank) * 8 + file + side);
+        }
+    }
+
+    initSlider(bishopMagics, bishopTable, BISHOP_MAGICS, BISHOP_DELTAS);
+    initSlider(rookMagics, rookTable, ROOK_MAGICS, ROOK_DELTAS);
+
+    // Two squares are aligned when a slider on one attacks the other on an empty board;
+    // the line is what both see from there, the squares between what they see of each other.
+    for (int from = 0; from < 64; from++) {
+        for (int to = 0; to < 64; to++) {
+            unsigned long long both = (1ULL << from) | (1ULL << to);
+            betweenMasks[from][to] = lineMasks[from][to] = 0ULL;
+            if (from == to) continue;
+            if (IS_BIT_SET(bishopAttacks(from, 0ULL), to)) {
+                lineMasks[from][to] = (bishopAttacks(from, 0ULL) & bishopAttacks(to, 0ULL)) | both;
+                betweenMasks[from][to] = bishopAttacks(from, both) & bishopAttacks(to, both);
+            } else if (IS_BIT_SET(rookAttacks(from, 0ULL), to)) {
+                lineMasks[from][to] = (rookAttacks(from, 0ULL) & rookAttacks(to, 0ULL)) | both;
+                betweenMasks[from][to] = rookAttacks(from, both) & rookAttacks(to, both);
+            }
+        }
+    }
+    initialized = 1;
+}
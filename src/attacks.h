@@ -0,0 +1,61 @@
+#ifndef ATTACKS
+#define ATTACKS
+
+#include "init.h"
+
+// Build with -mbmi2 to index the slider tables with PEXT instead of magic multiplication.
+#if defined(__BMI2__) && !defined(NO_PEXT)
+#include <immintrin.h>
+#define USE_PEXT 1
+#else
+#define USE_PEXT 0
+#endif
+
+// Colors, used to index the pawn attack table.
+enum colors { WHITE, BLACK };
+
+// Slider lookup entry: the relevant occupancy mask of a square and where its
+// attack sets start in the shared table.
+typedef struct magic {
+    unsigned long long mask;
+    unsigned long long magic;
+    unsigned long long *attacks;
+    int shift;
+} Magic;
+
+// Precomputed attack sets, filled by initAttacks
+extern unsigned long long knightAttacks[64];
+extern unsigned long long kingAttacks[64];
+extern unsigned long long pawnAttacks[2][64]; // squares a pawn of the color on the square captures on
+extern Magic bishopMagics[64];
+extern Magic rookMagics[64];
+extern unsigned long long betweenMasks[64][64]; // squares strictly between two aligned squares, else 0
+extern unsigned long long lineMasks[64][64]; // whole line through two aligned squares, else 0
+
+// Fills the tables above; cheap to call again once they are built
+void initAttacks(void);
+
+// Index of an occupancy in the attack sets of a slider square
+static inline unsigned int magicIndex(const Magic *entry, unsigned long long occupancy) {
+#if USE_PEXT
+    return (unsigned int)_pext_u64(occupancy, entry->mask);
+#else
+    return (unsigned int)(((occupancy & entry->mask) * entry->magic) >> entry->shift);
+#endif
+}
+
+static inline unsigned long long bishopAttacks(int square, unsigned long long occupancy) {
+    const Magic *entry = &bishopMagics[square];
+    return entry->attacks[magicIndex(entry, occupancy)];
+}
+
+static inline unsigned long long rookAttacks(int square, unsigned long long occupancy) {
+    const Magic *entry = &rookMagics[square];
+    return entry->attacks[magicIndex(entry, occupancy)];
+}
+
+static inline unsigned long long queenAttacks(int square, unsigned long long occupancy) {
+    return bishopAttacks(square, occupancy) | rookAttacks(square, occupancy);
+}
+
+#endif
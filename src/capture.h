@@ -2,31 +2,49 @@
 #define CAPTURE
 
 #include "init.h"
+#include "move.h"
 #include <stddef.h>
 
+// Check and pin information of the player to move, computed once per position
+// so that the generators emit legal moves only
+typedef struct checkInfo {
+    unsigned long long us; // pieces of the player to move
+    unsigned long long them; // pieces of the opponent
+    unsigned long long occupancy;
+    unsigned long long checkers; // enemy pieces giving check
+    unsigned long long pinned; // own pieces that may only move along the line to their king
+    unsigned long long evasions; // destinations that answer the check (all squares if none)
+    int kingSquare;
+} CheckInfo;
+
 //Function to check if a square is attacked
 int isSquareAttacked(Board board, int square);
+unsigned long long attackersTo(Board board, int square, unsigned long long occupancy);
 int KingSquare(Board board);
 int isKingAttacked(Board board);
+void computeCheckInfo(Board board, CheckInfo *info);
+
+// Material won (or lost, if negative) by a move once the captures on its square are played out
+int see(Board board, Move move);
 
-//Functions to return legal moves based on the application
-int appendString(char **buffer, size_t *size, size_t *len, const char *str);
-char *LegalALLMoves(Board board, const char *moves);
-char *LegalAttackMoves(Board board, const char *moves);
-char *LegalMoves(Board board, const char *moves);
 void squareToAlgebraic(short int square, char *buffer);
-char *filter_valid_moves(const char *input);
-int is_valid_move(const char *move);
-
-//Function to generate possible capture moves
-char *generatePawnCaptures(Board board);
-char *generateBishopCaptures(Board board);
-char *generateKnightCaptures(Board board);
-char *generateRookCaptures(Board board);
-char *generateQueenCaptures(Board board);
-char *generateKingCaptures(Board board);
-char *generateAllCaptures(Board board);
-char *generateLegalCaptures(Board board);
-char *generateLegalMoves(Board board);
+
+//Functions shared by the capture and the non-capture generators
+unsigned long long pieceTargets(int type, int square, unsigned long long occupancy);
+void generatePieceMoves(Board board, MoveList *list, int type, unsigned long long mask, int flags, const CheckInfo *info);
+
+//Function to generate legal capture moves
+void generatePawnCaptures(Board board, MoveList *list, const CheckInfo *info);
+void generateBishopCaptures(Board board, MoveList *list, const CheckInfo *info);
+void generateKnightCaptures(Board board, MoveList *list, const CheckInfo *info);
+void generateRookCaptures(Board board, MoveList *list, const CheckInfo *info);
+void generateQueenCaptures(Board board, MoveList *list, const CheckInfo *info);
+void generateKingCaptures(Board board, MoveList *list, const CheckInfo *info);
+void generateAllCaptures(Board board, MoveList *list, const CheckInfo *info);
+void generateLegalCaptures(Board board, MoveList *list);
+void generateLegalMoves(Board board, MoveList *list);
+
+// Returns nonzero if the player to move has at least one legal move
+int hasLegalMove(Board board);
 
 #endif
@@ -2,6 +2,9 @@
  #include <stdlib.h>
  #include <stdarg.h>
  #include <string.h>
+ #include <time.h>
+ #include <pthread.h>
+ #include <stdatomic.h>
  
  #include "bitboard.h" 
  #include "evaluate.h" 
@@ -10,12 +13,23 @@
  #include "init.h"
  #include "tools.h"
  #include "capture.h"
+ #include "attacks.h"
+ #include "perft.h"
+ #include "transposition.h"
+ #include "threads.h"
+ #include "nnue.h"
  
  /*
  ./engine "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1" \
  "a3 a4 b3 b4 c3 c4 d3 d4 e3 e4 f3 f4 g3 g4 h3 h4 Na3 Nc3 Nf3 Nh3" \
  3
 
+ ./engine perft 5 "r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1"
+ ./engine perft suite
+ ./engine qsearch suite
+ ./engine batch 100 positions.epd
+ ./engine uci
+
  make WEB_TARGET=web/engine.wasm web/engine.wasm
 
  $ make run
@@ -25,11 +39,22 @@ Serving HTTP on 0.0.0.0 port 8000 (http://0.0.0.0:8000/) ...
  */
  
  /**
-  * @brief Chooses the best move from a given list of legal moves using minimax evaluation.
+  * @brief Loads the network of NNUE_DEFAULT_FILE and evaluates with it, if the file is there; only
+  * the first call of a process looks for it.
+  */
+ static void useDefaultNetwork(void) {
+     static int tried = 0;
+     if (tried) return;
+     tried = 1;
+     if (!nnueLoaded() && nnueLoad(NNUE_DEFAULT_FILE) == 0) nnueUse(1);
+ }
+
+ /**
+  * @brief Chooses the best move from a given list of legal moves using an iterative deepening negamax search.
   *
   * @param fen A string representing the board position in Forsyth-Edwards Notation (FEN).
   * @param moves A string containing all legal moves.
-  * @param timeout An integer representing the maximum allowed computation time.
+  * @param timeout An integer representing the maximum allowed computation time, in seconds.
   * @return The index of the best move in the given list, or -1 in case of memory allocation failure.
   */
  int choose_move(char * fen, char * moves, int timeout) {
@@ -40,24 +65,16 @@ Serving HTTP on 0.0.0.0 port 8000 (http://0.0.0.0:8000/) ...
          return -1;
      }
  
-     // Initialisize board.
+     // Initialisize board and the attack tables (built once per process).
      memset(board,0,sizeof(struct board));
- 
-     Board tempBoard = NULL; // to copy the board in
-     tempBoard = malloc(sizeof(struct board));
-     if (!tempBoard) {
-         return -1;
-     }
+     initAttacks();
+     useDefaultNetwork(); // before the board is set up, which then fills the accumulators
  
      char *testMoves = moves;
      if (testMoves == NULL) {
          free(board);
-         free(tempBoard);
          return 0;
      }
-     
-     // Initialisize temporary board (to avoid memory leaks and errors).
-     memset(tempBoard,0,sizeof(struct board));
  
      // Read and create the board from the FEN string.
      parseFenRec(board, fen); 
@@ -68,7 +85,6 @@ Serving HTTP on 0.0.0.0 port 8000 (http://0.0.0.0:8000/) ...
      char **choices = initMoveSave(testMoves, &returnSize); 
      if(!choices) {
          free(board);
-         free(tempBoard);
          return -1;
      }
      
@@ -76,48 +92,540 @@ Serving HTTP on 0.0.0.0 port 8000 (http://0.0.0.0:8000/) ...
          // free everything
          freeMoveSave(choices, returnSize);
          free(board);
-         free(tempBoard);
          return 0; // return the index of the only legal move
      }
  
-     // For every possible move, evaluate the board.
-     int max = 0, flag = 1, currentVal = 0, i = 0; 
- 
-     for (i = 0; i < returnSize; i++) {
-         // Copy the data from board to tempBoard.
-         memcpy(tempBoard, board, sizeof(struct board));
- 
-         // Update the temp board with the possible move.
-         UpdateBitboards(tempBoard, choices[i]);
-        
-         int depth = 2;
-         if (timeout <= 1) depth = 1;
-         // Get the value given by this move.
-         currentVal = minimax(tempBoard, depth, -1e9, 1e9, true);
-         if(DEBUG)printBoard(tempBoard);
-         
-         // Compare the value to max.
-         if (!flag) {
-             if (max < (currentVal)) {
-                 max = currentVal;
-                 index = i; // update max and index
-             }
-         } else {
-             flag = 0;
-             max = (currentVal);
-             index = i; // update max and index
+     // Match the given moves against the legal moves of the position,
+     // so that the search only deals with packed moves from here on.
+     MoveList legal;
+     generateLegalMoves(board, &legal);
+
+     Move rootMoves[MAX_MOVES];
+     int rootChoices[MAX_MOVES]; // index in choices of every root move
+     int count = 0;
+     for (int i = 0; i < returnSize && count < MAX_MOVES; i++) {
+         Move move = sanToMove(board, choices[i], &legal);
+         if (move == NO_MOVE) {
+             debugPrint("Move %s is not legal in this position\n", choices[i]);
+             continue;
          }
-         debugPrint("index: %d, max: %d, currentVal: %d\n", index, max, currentVal);
-     }    
- 
+         rootMoves[count] = move;
+         rootChoices[count++] = i;
+     }
+
+     // The transposition table outlives a call, so that later calls (web interface)
+     // start from what earlier ones found; their entries are replaced first.
+     if (!ttAllocated()) ttResize(TT_DEFAULT_MB);
+     ttNewSearch();
+
+     // Spend the timeout (given in seconds) on deeper and deeper searches.
+     if (count > 0) {
+         SearchLimits limits = {0};
+         limits.time.moveTime = timeout > 0 ? (long long)timeout * 1000 : 1;
+         index = rootChoices[iterativeDeepening(board, rootMoves, count, &limits, NULL)];
+     }
+     debugPrint("index: %d\n", index);
+
      // Free everything.
      freeMoveSave(choices, returnSize);
      free(board);
-     free(tempBoard);
      
      return index;
  }
  
+ /**
+  * @brief Runs the perft mode: the divide of one position, or the whole suite.
+  *
+  * @param argc The number of command-line arguments.
+  * @param argv "perft" followed by "suite", or by a depth and an optional FEN (start position by default).
+  * @return Returns 0 on success, or an error code on failure or on a suite mismatch.
+  */
+ static int perftMode(int argc, char * argv[]) {
+     if (argc >= 3 && strcmp(argv[2], "suite") == 0) {
+         return perftSuite() ? ERROR_CODE : 0;
+     }
+
+     int depth = (argc >= 3) ? atoi(argv[2]) : 0;
+     if (depth < 1) {
+         fprintf(stderr, "Usage: %s perft <depth> [fen] | %s perft suite\n", argv[0], argv[0]);
+         return ERROR_CODE;
+     }
+
+     struct board board;
+     memset(&board, 0, sizeof(board));
+     char *fen = (argc >= 4) ? argv[3] : "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1";
+     if (parseFenRec(&board, fen) != 0) {
+         fprintf(stderr, "FEN parsing failed\n");
+         return ERROR_CODE;
+     }
+     perftDivide(&board, depth);
+     return 0;
+ }
+
+ /**
+  * @brief Copies the position part of a FEN or EPD record into a complete FEN: the first four fields,
+  * then the move counters if the record has them (EPD operations such as "bm e4;" take their place
+  * otherwise and are skipped).
+  *
+  * @param text The record, read up to its end or up to the first field that follows the position.
+  * @param fen Receives the FEN.
+  * @param size The size of fen.
+  * @return The number of characters of text the position took, or ERROR_CODE if it has fewer than four fields.
+  */
+ static int normalizeFen(const char *text, char *fen, size_t size) {
+     const char *fields[6];
+     int lengths[6], count = 0, i = 0, end = 0;
+     while (count < 6) {
+         while (text[i] == ' ' || text[i] == '\t') i++;
+         if (text[i] == '\0' || text[i] == '\n' || text[i] == '\r') break;
+         fields[count] = text + i;
+         while (text[i] && text[i] != ' ' && text[i] != '\t' && text[i] != '\n' && text[i] != '\r') i++;
+         lengths[count] = (int)(text + i - fields[count]);
+         // Counters are only taken if both are there and are numbers.
+         if (count == 4 && strspn(fields[4], "0123456789") != (size_t)lengths[4]) break;
+         if (count == 5 && strspn(fields[5], "0123456789") != (size_t)lengths[5]) break;
+         count++;
+         if (count == 4 || count == 6) end = i;
+     }
+     if (count < 4) return ERROR_CODE;
+     if (lengths[1] != 1 || (fields[1][0] != 'w' && fields[1][0] != 'b')) return ERROR_CODE;
+     if (strspn(fields[0], "PRNBQKprnbqk12345678/") != (size_t)lengths[0]) return ERROR_CODE;
+
+     int written;
+     if (count == 6) {
+         written = snprintf(fen, size, "%.*s %.*s %.*s %.*s %.*s %.*s", lengths[0], fields[0], lengths[1], fields[1],
+                            lengths[2], fields[2], lengths[3], fields[3], lengths[4], fields[4], lengths[5], fields[5]);
+     } else {
+         written = snprintf(fen, size, "%.*s %.*s %.*s %.*s 0 1", lengths[0], fields[0], lengths[1], fields[1],
+                            lengths[2], fields[2], lengths[3], fields[3]);
+     }
+     if (written < 0 || (size_t)written >= size) return ERROR_CODE;
+     return end;
+ }
+
+ /**
+  * @brief Formats a score the way UCI does: "cp" and centipawns, or "mate" and the number of moves
+  * to mate (negative if the side to move is the one mated). Scores are kept in engine units,
+  * P_VALUE to a pawn, and converted to centipawns here.
+  *
+  * @param buffer Receives the text.
+  * @param size Size of buffer.
+  * @param score The score, from the point of view of the player to move.
+  * @return The length of the text, as snprintf returns it.
+  */
+ static int formatScore(char *buffer, size_t size, int score) {
+     if (score >= MATE_IN_MAX) return snprintf(buffer, size, "mate %d", (MATE_SCORE - score + 1) / 2);
+     if (score <= -MATE_IN_MAX) return snprintf(buffer, size, "mate %d", -(MATE_SCORE + score) / 2);
+     return snprintf(buffer, size, "cp %d", score * 100 / P_VALUE);
+ }
+
+ // @brief: prints a score as formatScore formats it.
+ static void printScore(int score) {
+     char buffer[16];
+     formatScore(buffer, sizeof(buffer), score);
+     fputs(buffer, stdout);
+ }
+
+ /**
+  * @brief Runs the batch mode: searches every position of an EPD/FEN stream (one per line, empty lines and
+  * lines starting with '#' skipped) for the same time and prints one line per position:
+  * "bestmove <move> score <cp|mate> <n> depth <depth> nodes <nodes>" (scores in centipawns, see
+  * formatScore), or "error" for a line that is not a position. Tables and threads are set up once for
+  * the whole stream, and so is the network: the one given, or NNUE_DEFAULT_FILE if it exists.
+  *
+  * @param argc The number of command-line arguments.
+  * @param argv "batch" followed by the time per position in ms, an optional file (stdin by default, or "-")
+  * and an optional network file.
+  * @return Returns 0 on success, or an error code if the arguments or the file are wrong.
+  */
+ static int batchMode(int argc, char * argv[]) {
+     long long budget = (argc >= 3) ? atoll(argv[2]) : 0;
+     if (budget < 1) {
+         fprintf(stderr, "Usage: %s batch <ms per position> [file] [network]\n", argv[0]);
+         return ERROR_CODE;
+     }
+     FILE *input = stdin;
+     if (argc >= 4 && strcmp(argv[3], "-") != 0) {
+         input = fopen(argv[3], "r");
+         if (!input) {
+             fprintf(stderr, "Cannot open %s\n", argv[3]);
+             return ERROR_CODE;
+         }
+     }
+
+     // A network given on the command line must load; otherwise the default one is used if it is there.
+     if (argc >= 5) {
+         if (nnueLoad(argv[4]) != 0) {
+             fprintf(stderr, "Cannot load network %s\n", argv[4]);
+             if (input != stdin) fclose(input);
+             return ERROR_CODE;
+         }
+         nnueUse(1);
+     } else {
+         useDefaultNetwork();
+     }
+     if (!ttAllocated()) ttResize(TT_DEFAULT_MB);
+
+     char line[1024], fen[256], buffer[6];
+     struct board board;
+     unsigned long long positions = 0, totalNodes = 0;
+     long long start = timeMilliseconds();
+     while (fgets(line, sizeof(line), input)) {
+         if (line[strspn(line, " \t\r\n")] == '\0' || line[0] == '#') continue;
+
+         memset(&board, 0, sizeof(board));
+         if (normalizeFen(line, fen, sizeof(fen)) == ERROR_CODE || parseFenRec(&board, fen) != 0 ||
+             __builtin_popcountll(board.bitboards[WHITE_KING]) != 1 ||
+             __builtin_popcountll(board.bitboards[BLACK_KING]) != 1) {
+             printf("error\n");
+             fflush(stdout);
+             continue;
+         }
+
+         MoveList legal;
+         generateLegalMoves(&board, &legal);
+         SearchResult result = {0};
+         if (legal.count == 0) {
+             // Mated or stalemated: nothing to search.
+             result.score = isKingAttacked(&board) ? -MATE_SCORE : 0;
+             strcpy(buffer, "0000"); // the UCI null move
+         } else {
+             // Nobody waits for the answer, so the whole time goes to the search.
+             SearchLimits limits = {0};
+             limits.time.moveTime = budget + MOVE_OVERHEAD;
+             ttNewSearch();
+             iterativeDeepening(&board, legal.moves, legal.count, &limits, &result);
+             moveToUci(legal.moves[result.best], buffer);
+         }
+
+         printf("bestmove %s score ", buffer);
+         printScore(result.score);
+         printf(" depth %d nodes %llu\n", result.depth, result.nodes);
+         fflush(stdout);
+         positions++;
+         totalNodes += result.nodes;
+     }
+
+     if (input != stdin) fclose(input);
+     unsigned long long probes, hits;
+     evalCacheStats(&probes, &hits);
+     fprintf(stderr, "%llu positions, %llu nodes in %lld ms, eval cache hits %llu of %llu (%.1f%%)\n", positions, totalNodes,
+             timeMilliseconds() - start, hits, probes, probes ? 100.0 * hits / probes : 0.0);
+     return 0;
+ }
+
+ // State the UCI front end keeps between commands: the position, and the search running on it
+ static struct board uciBoard;
+ static MoveList uciRoot; // legal moves of uciBoard, the root moves of the search
+ static atomic_int uciStop; // set by "stop" (or any command that needs the search over)
+ static SearchLimits uciLimits;
+
+ // The search thread is created at the first "go" and kept until "quit", sleeping between searches,
+ // so that its thread-local tables (the pawn hash table, the eval cache counters) outlive a move.
+ static pthread_t uciSearcher;
+ static int uciSearcherStarted = 0;
+ static pthread_mutex_t uciLock = PTHREAD_MUTEX_INITIALIZER;
+ static pthread_cond_t uciWake = PTHREAD_COND_INITIALIZER; // a search was handed over, or the thread quits
+ static pthread_cond_t uciDone = PTHREAD_COND_INITIALIZER; // the search answered "bestmove"
+ static int uciSearching = 0; // a search was handed over and did not answer yet
+ static int uciQuitting = 0;
+
+ /**
+  * @brief Prints a line of the UCI protocol and flushes it at once (the GUI reads a pipe). The line
+  * is formatted first and written with a single call, so that lines the command reader and the
+  * search thread send at the same time never mix.
+  */
+ static void uciSend(const char *format, ...) {
+     char line[1024];
+     va_list args;
+     va_start(args, format);
+     int length = vsnprintf(line, sizeof(line) - 1, format, args);
+     va_end(args);
+     if (length < 0) return;
+     if (length > (int)sizeof(line) - 2) length = (int)sizeof(line) - 2;
+     line[length] = '\n';
+     line[length + 1] = '\0';
+     fputs(line, stdout);
+     fflush(stdout);
+ }
+
+ /**
+  * @brief Reports a completed iteration as a UCI "info" line.
+  *
+  * @param result What the search found so far.
+  */
+ static void uciReport(const SearchResult *result) {
+     char buffer[6], score[16];
+     moveToUci(uciRoot.moves[result->best], buffer);
+     formatScore(score, sizeof(score), result->score);
+     unsigned long long nps = result->time > 0 ? result->nodes * 1000ULL / (unsigned long long)result->time : 0ULL;
+     uciSend("info depth %d score %s nodes %llu nps %llu time %lld pv %s", result->depth, score, result->nodes, nps,
+             result->time, buffer);
+ }
+
+ /**
+  * @brief Searches uciBoard and answers "bestmove". An infinite search
+  * only answers once told to stop, even if it ran out of iterations before.
+  */
+ static void uciSearch(void) {
+     char buffer[6] = "0000"; // the null move, if there is no legal move
+     if (uciRoot.count > 0) {
+         unsigned long long probesBefore, hitsBefore, probes, hits;
+         evalCacheStats(&probesBefore, &hitsBefore);
+         ttNewSearch();
+         int best = iterativeDeepening(&uciBoard, uciRoot.moves, uciRoot.count, &uciLimits, NULL);
+         moveToUci(uciRoot.moves[best], buffer);
+         evalCacheStats(&probes, &hits);
+         probes -= probesBefore;
+         hits -= hitsBefore;
+         uciSend("info string eval cache hits %llu of %llu (%.1f%%)", hits, probes, probes ? 100.0 * hits / probes : 0.0);
+     }
+     while (uciLimits.infinite && !atomic_load(&uciStop)) {
+         struct timespec pause = {0, 1000000L};
+         nanosleep(&pause, NULL);
+     }
+     uciSend("bestmove %s", buffer);
+ }
+
+ /**
+  * @brief Body of the search thread: waits for a search, runs it, reports back, and again.
+  */
+ static void *uciSearcherLoop(void *argument) {
+     (void)argument;
+     pthread_mutex_lock(&uciLock);
+     while (1) {
+         while (!uciSearching && !uciQuitting) pthread_cond_wait(&uciWake, &uciLock);
+         if (uciQuitting) break;
+         pthread_mutex_unlock(&uciLock);
+
+         uciSearch();
+
+         pthread_mutex_lock(&uciLock);
+         uciSearching = 0;
+         pthread_cond_signal(&uciDone);
+     }
+     pthread_mutex_unlock(&uciLock);
+     return NULL;
+ }
+
+ /**
+  * @brief Ends the running search, if any, and waits for its "bestmove".
+  */
+ static void uciStopSearch(void) {
+     pthread_mutex_lock(&uciLock);
+     if (uciSearching) atomic_store(&uciStop, 1);
+     while (uciSearching) pthread_cond_wait(&uciDone, &uciLock);
+     pthread_mutex_unlock(&uciLock);
+ }
+
+ /**
+  * @brief Ends the running search, if any, and the search thread.
+  */
+ static void uciStopSearcher(void) {
+     uciStopSearch();
+     if (!uciSearcherStarted) return;
+     pthread_mutex_lock(&uciLock);
+     uciQuitting = 1;
+     pthread_cond_signal(&uciWake);
+     pthread_mutex_unlock(&uciLock);
+     pthread_join(uciSearcher, NULL);
+     uciSearcherStarted = 0;
+     uciQuitting = 0;
+ }
+
+ /**
+  * @brief Handles "position [startpos | fen <fen>] [moves <move> ...]".
+  *
+  * @param arguments The command line after "position".
+  */
+ static void uciPosition(char *arguments) {
+     char fen[256];
+     char *rest = arguments;
+     while (*rest == ' ') rest++;
+     if (strncmp(rest, "startpos", 8) == 0) {
+         strcpy(fen, "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1");
+         rest += 8;
+     } else if (strncmp(rest, "fen", 3) == 0) {
+         int length = normalizeFen(rest + 3, fen, sizeof(fen));
+         if (length == ERROR_CODE) return;
+         rest += 3 + length;
+     } else {
+         return;
+     }
+
+     struct board board;
+     memset(&board, 0, sizeof(board));
+     if (parseFenRec(&board, fen) != 0) return;
+
+     // Play the moves; the position is only taken if all of them are legal.
+     MoveList legal;
+     char *moves = strstr(rest, "moves");
+     if (moves) {
+         char *token = strtok(moves + 5, " \t");
+         while (token) {
+             generateLegalMoves(&board, &legal);
+             Move move = uciToMove(token, &legal);
+             if (move == NO_MOVE || board.ply >= MAX_HISTORY - MAX_PLY) return;
+             makeMove(&board, move);
+             token = strtok(NULL, " \t");
+         }
+     }
+     memcpy(&uciBoard, &board, sizeof(board));
+ }
+
+ /**
+  * @brief Handles "go" with its wtime, btime, winc, binc, movestogo, movetime, depth and infinite
+  * parameters, and starts the search in its own thread.
+  *
+  * @param arguments The command line after "go".
+  */
+ static void uciGo(char *arguments) {
+     long long time[2] = {0, 0}, increment[2] = {0, 0}, moveTime = 0;
+     int movesToGo = 0;
+
+     memset(&uciLimits, 0, sizeof(uciLimits));
+     char *token = strtok(arguments, " \t");
+     while (token) {
+         char *value = strtok(NULL, " \t");
+         if (strcmp(token, "infinite") == 0) {
+             uciLimits.infinite = 1;
+             token = value;
+             continue;
+         }
+         if (!value) break;
+         if (strcmp(token, "wtime") == 0) time[WHITE] = atoll(value);
+         else if (strcmp(token, "btime") == 0) time[BLACK] = atoll(value);
+         else if (strcmp(token, "winc") == 0) increment[WHITE] = atoll(value);
+         else if (strcmp(token, "binc") == 0) increment[BLACK] = atoll(value);
+         else if (strcmp(token, "movestogo") == 0) movesToGo = atoi(value);
+         else if (strcmp(token, "movetime") == 0) moveTime = atoll(value);
+         else if (strcmp(token, "depth") == 0) uciLimits.depth = atoi(value);
+         else {
+             token = value; // a parameter without a value we do not know: skip it only
+             continue;
+         }
+         token = strtok(NULL, " \t");
+     }
+
+     // The time manager turns the clock of the player to move into deadlines.
+     int side = (uciBoard.toMove == 'w') ? WHITE : BLACK;
+     if (!uciLimits.infinite) {
+         uciLimits.time.time = time[side];
+         uciLimits.time.increment = increment[side];
+         uciLimits.time.movesToGo = movesToGo;
+         uciLimits.time.moveTime = moveTime;
+     }
+     uciLimits.stop = &uciStop;
+     uciLimits.report = uciReport;
+
+     generateLegalMoves(&uciBoard, &uciRoot);
+     atomic_store(&uciStop, 0);
+     if (!uciSearcherStarted) uciSearcherStarted = (pthread_create(&uciSearcher, NULL, uciSearcherLoop, NULL) == 0);
+     if (!uciSearcherStarted) {
+         uciSearch(); // no thread to spare: search right here, "stop" cannot interrupt it
+         return;
+     }
+     pthread_mutex_lock(&uciLock);
+     uciSearching = 1;
+     pthread_cond_signal(&uciWake);
+     pthread_mutex_unlock(&uciLock);
+ }
+
+ /**
+  * @brief Handles "setoption name <Hash | Threads> value <n>", "setoption name EvalFile value <path>"
+  * and "setoption name UseNNUE value <true | false>". The network is used only once both a file was
+  * loaded and UseNNUE is true, whichever comes first.
+  *
+  * @param arguments The command line after "setoption".
+  */
+ static void uciSetOption(char *arguments) {
+     static int useNnue = 0;
+     char *name = strstr(arguments, "name ");
+     char *value = strstr(arguments, "value ");
+     if (!name || !value) return;
+     name += 5;
+     value += 6;
+     int number = atoi(value);
+     if (strncmp(name, "Hash", 4) == 0 && number > 0) {
+         ttResize(number);
+     } else if (strncmp(name, "Threads", 7) == 0 && number > 0) {
+         setThreadCount(number);
+     } else if (strncmp(name, "EvalFile", 8) == 0) {
+         if (nnueLoad(value) != 0) {
+             uciSend("info string cannot load network %s, using the classical evaluation", value);
+         } else {
+             uciSend("info string loaded network %s (%s)", value, nnueKernel());
+         }
+     } else if (strncmp(name, "UseNNUE", 7) == 0) {
+         useNnue = strncmp(value, "true", 4) == 0;
+     } else {
+         return;
+     }
+     // The accumulators of the current position are only kept while the network is in use, and
+     // scores cached by the other evaluation no longer hold.
+     if (nnueUse(useNnue)) nnueRefresh(&uciBoard);
+     evalCacheClear();
+ }
+
+ // @brief: tells whether the first word of a line (length characters long) is the given command.
+ static int isCommand(const char *command, size_t length, const char *name) {
+     return strlen(name) == length && strncmp(command, name, length) == 0;
+ }
+
+ /**
+  * @brief Runs the engine as a UCI engine: reads commands from stdin until "quit" (or the end of the
+  * input). The transposition table, the search threads and their history tables are kept from one
+  * move to the next; only "ucinewgame" clears the table.
+  *
+  * @return Returns 0.
+  */
+ static int uciLoop(void) {
+     char line[8192];
+     memset(&uciBoard, 0, sizeof(uciBoard));
+     parseFenRec(&uciBoard, "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1");
+     if (!ttAllocated()) ttResize(TT_DEFAULT_MB);
+     if (!threadCount()) setThreadCount(DEFAULT_THREADS);
+
+     while (fgets(line, sizeof(line), stdin)) {
+         line[strcspn(line, "\r\n")] = '\0';
+         char *command = line + strspn(line, " \t");
+         size_t length = strcspn(command, " \t");
+         char *arguments = command + length + (command[length] != '\0');
+
+         if (isCommand(command, length, "uci")) {
+             uciSend("id name Fork Overflow");
+             uciSend("id author Fork Overflow Team");
+             uciSend("option name Hash type spin default %d min 1 max 65536", TT_DEFAULT_MB);
+             uciSend("option name Threads type spin default %d min 1 max %d", threadCount(), MAX_THREADS);
+             uciSend("option name EvalFile type string default <empty>");
+             uciSend("option name UseNNUE type check default false");
+             uciSend("uciok");
+         } else if (isCommand(command, length, "isready")) {
+             uciSend("readyok");
+         } else if (isCommand(command, length, "ucinewgame")) {
+             uciStopSearch();
+             ttClear();
+         } else if (isCommand(command, length, "position")) {
+             uciStopSearch();
+             uciPosition(arguments);
+         } else if (isCommand(command, length, "go")) {
+             uciStopSearch();
+             uciGo(arguments);
+         } else if (isCommand(command, length, "stop")) {
+             uciStopSearch();
+         } else if (isCommand(command, length, "setoption")) {
+             uciStopSearch();
+             uciSetOption(arguments);
+         } else if (isCommand(command, length, "quit")) {
+             break;
+         }
+     }
+
+     uciStopSearcher();
+     ttFree();
+     return 0;
+ }
+
  /**
   * @brief Main function to run the chess engine.
   *
@@ -130,9 +638,33 @@ Serving HTTP on 0.0.0.0 port 8000 (http://0.0.0.0:8000/) ...
   */
  
  int main(int argc, char * argv[]) {
+     // Perft mode to check and time the move generator.
+     if (argc >= 2 && strcmp(argv[1], "perft") == 0) {
+         initAttacks();
+         return perftMode(argc, argv);
+     }
+
+     // Quiescence search checks, next to the perft suite.
+     if (argc == 3 && strcmp(argv[1], "qsearch") == 0 && strcmp(argv[2], "suite") == 0) {
+         initAttacks();
+         return quiescenceSuite() ? ERROR_CODE : 0;
+     }
+
+     // UCI mode, also when started without arguments (as chess GUIs do).
+     if (argc == 1 || (argc == 2 && strcmp(argv[1], "uci") == 0)) {
+         initAttacks();
+         return uciLoop();
+     }
+
+     // Batch mode to analyse a whole stream of positions in one process.
+     if (argc >= 2 && strcmp(argv[1], "batch") == 0) {
+         initAttacks();
+         return batchMode(argc, argv);
+     }
+
      // First and foremost checking if the user has
      // entered the correct types and numbers of parameters.
-     if (argc > 4) {
+     if (argc != 4) {
          fprintf(stderr, "Only %d arguments were given.\n", argc);
          fprintf(stderr, "Usage: %s <fen> <moves> <timeout>.\n", argv[0]);
          return ERROR_CODE;
@@ -148,8 +680,9 @@ Serving HTTP on 0.0.0.0 port 8000 (http://0.0.0.0:8000/) ...
         return ERROR_CODE;
      }
  
-     // Initialisizing the board.
+     // Initialisizing the board and the attack tables.
      memset(board,0,sizeof(struct board));
+     initAttacks();
  
      // Reading the three arguments given by the user.
      // 1. Reading fen data.
@@ -185,7 +718,12 @@ Serving HTTP on 0.0.0.0 port 8000 (http://0.0.0.0:8000/) ...
          free(board);
          return ERROR_CODE;
      }
-     if(DEBUG)UpdateBitboards(board, choices[move_chosen]);
+     if (DEBUG) {
+         MoveList legal;
+         generateLegalMoves(board, &legal);
+         Move move = sanToMove(board, choices[move_chosen], &legal);
+         if (move != NO_MOVE) makeMove(board, move);
+     }
      if (DEBUG) printBoard(board);
      if (DEBUG) fprintBitToFen(stdout, board);
      if (DEBUG) debugPrint("\n%s\n", choices[move_chosen]);
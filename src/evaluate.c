@@ -1,14 +1,35 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <stdatomic.h>
+#include <limits.h>
 
 #include "evaluate.h"
 #include "bitboard.h"
 #include "init.h"
-#include "evaluate.h"
+#include "attacks.h"
+#include "pawns.h"
+#include "nnue.h"
+
+// Piece values, in the order of the bitboards
+int pieceValues[12] = {P_VALUE, R_VALUE, N_VALUE, B_VALUE, Q_VALUE, K_VALUE, -P_VALUE, -R_VALUE, -N_VALUE, -B_VALUE, -Q_VALUE, -K_VALUE};
+
+int pieceSquareMg[12][64];
+int pieceSquareEg[12][64];
+
+/*
+Evaluation cache, shared by the search threads: one word per entry holds the upper 48 bits of the
+position key and the 16-bit score, so an entry is read and written in one piece without locks, and
+the lower bits of the key pick the entry. A colliding position simply overwrites the older one.
+*/
+static _Atomic unsigned long long evalCache[EVAL_CACHE_SIZE];
+#define EVAL_CACHE_TAG 0xFFFFFFFFFFFF0000ULL
 
-// Piece values
-int pieceValues[12] = {P_VALUE, N_VALUE, B_VALUE, R_VALUE, Q_VALUE, K_VALUE, -P_VALUE, -N_VALUE, -B_VALUE, -R_VALUE, -Q_VALUE, -K_VALUE};
+static _Atomic unsigned long long cacheProbes, cacheHits;
+static _Thread_local unsigned long long localProbes, localHits; // not yet added to the counters above
+
+// Weight of every piece in the game phase, in the order of the bitboards
+int piecePhase[12] = {0, 2, 1, 1, 4, 0, 0, 2, 1, 1, 4, 0};
 
 // Piece-square tables (example values, can be tuned)
 const int pawn_table[64] = {
@@ -88,7 +109,43 @@ const int king_table_endgame[64] = {
     -50,-30,-30,-30,-30,-30,-30,-50
 };
 
-// returns piece index or -1 if the square is empty
+/*
+@brief: fills pieceSquareMg and pieceSquareEg. The tables above are written from white's side,
+first row rank 1, while squares count from a8: a white piece reads its table with the rank
+flipped (square ^ 56), a black piece reads it as is, which mirrors it to black's side.
+*/
+void initPieceSquare(void) {
+    static int initialized = 0;
+    if (initialized) return;
+
+    const int *tables[6] = {pawn_table, rook_table, knight_table, bishop_table, queen_table, king_table};
+    for (int type = 0; type < 6; type++) {
+        const int *endgame = (type == WHITE_KING) ? king_table_endgame : tables[type];
+        for (int square = 0; square < 64; square++) {
+            pieceSquareMg[type][square] = tables[type][square ^ 56];
+            pieceSquareEg[type][square] = endgame[square ^ 56];
+            pieceSquareMg[type + 6][square] = -tables[type][square];
+            pieceSquareEg[type + 6][square] = -endgame[square];
+        }
+    }
+    initialized = 1;
+}
+
+void computePieceSquare(Board board) {
+    board->material = board->psqMg = board->psqEg = board->phase = 0;
+    for (int piece = 0; piece < 12; piece++) {
+        unsigned long long pieces = board->bitboards[piece];
+        while (pieces) {
+            int square = __builtin_ctzll(pieces);
+            board->material += pieceValues[piece];
+            board->psqMg += pieceSquareMg[piece][square];
+            board->psqEg += pieceSquareEg[piece][square];
+            board->phase += piecePhase[piece];
+            pieces &= pieces - 1;
+        }
+    }
+}
+
 // returns piece index or -1 if the square is empty
 int whatPiece(unsigned long long bitboards[12], short int sqr) {
     int piece;
@@ -111,318 +168,171 @@ short int getKingSquare(unsigned long long bitboards[12], char usPlayer) {
     }
 }
 
-// Evaluate the position based on material balance
+// Evaluate the position based on material balance (kept up to date by makeMove)
 int evaluateMaterial(Board board){
-    int score = 0;
-    int player = (board->toMove == 'w') ? 1 : -1;
-
-    // Material balance
-    score += __builtin_popcountll(board->bitboards[WHITE_PAWNS]) * P_VALUE;
-    score += __builtin_popcountll(board->bitboards[WHITE_ROOKS]) * R_VALUE;
-    score += __builtin_popcountll(board->bitboards[WHITE_KNIGHTS]) * N_VALUE;
-    score += __builtin_popcountll(board->bitboards[WHITE_BISHOPS]) * B_VALUE;
-    score += __builtin_popcountll(board->bitboards[WHITE_QUEEN]) * Q_VALUE;
-    score += __builtin_popcountll(board->bitboards[WHITE_KING]) * K_VALUE;
-
-    score -= __builtin_popcountll(board->bitboards[BLACK_PAWNS]) * P_VALUE;
-    score -= __builtin_popcountll(board->bitboards[BLACK_ROOKS]) * R_VALUE;
-    score -= __builtin_popcountll(board->bitboards[BLACK_KNIGHTS]) * N_VALUE;
-    score -= __builtin_popcountll(board->bitboards[BLACK_BISHOPS]) * B_VALUE;
-    score -= __builtin_popcountll(board->bitboards[BLACK_QUEEN]) * Q_VALUE;
-    score -= __builtin_popcountll(board->bitboards[BLACK_KING]) * K_VALUE;
-
-    if (player == -1) score = -score;
-    
-    return score;
+    return (board->toMove == 'w') ? board->material : -board->material;
 }
 
-// Evaluate the position based on piece-square tables
-int evaluatePosition(Board board, int gameState){
-    int player = (board->toMove == 'w') ? 1 : -1;
-    int score = 0;
-
-    // Piece-square tables
-    for (int square = 63; square > -1; square--) {
-        if (IS_BIT_SET(board->bitboards[WHITE_PAWNS], square)) {
-            score += pawn_table[square];
-        }
-        if (IS_BIT_SET(board->bitboards[BLACK_PAWNS], square)) {
-            score -= pawn_table[63 - square]; // Flip for black
-        }
-
-        if (IS_BIT_SET(board->bitboards[WHITE_KNIGHTS], square)) {
-            score += knight_table[square];
-        }
-        if (IS_BIT_SET(board->bitboards[BLACK_KNIGHTS], square)) {
-            score -= knight_table[63 - square];
-        }
-
-        if (IS_BIT_SET(board->bitboards[WHITE_BISHOPS], square)) {
-            score += bishop_table[square];
-        }
-        if (IS_BIT_SET(board->bitboards[BLACK_BISHOPS], square)) {
-            score -= bishop_table[63 - square];
-        }
-
-        if (IS_BIT_SET(board->bitboards[WHITE_ROOKS], square)) {
-            score += rook_table[square];
-        }
-        if (IS_BIT_SET(board->bitboards[BLACK_ROOKS], square)) {
-            score -= rook_table[63 - square];
-        }
-
-        if (IS_BIT_SET(board->bitboards[WHITE_QUEEN], square)) {
-            score += queen_table[square];
-        }
-        if (IS_BIT_SET(board->bitboards[BLACK_QUEEN], square)) {
-            score -= queen_table[63 - square];
-        }
-
-        if (IS_BIT_SET(board->bitboards[WHITE_KING], square)) {
-            if(gameState == 2){ 
-                score += king_table_endgame[square];
-            }else{
-                score += king_table[square];
-            }
-        }
-        if (IS_BIT_SET(board->bitboards[BLACK_KING], square)) {
-            if(gameState == 2){ 
-                score -= king_table_endgame[63 - square];
-            }else{
-                score -= king_table[63 - square];
-            }
-        }
-    }
-        if(player == -1) score = -score;
-
-        return score;
+/*
+@brief: blends a middlegame and an endgame score by the game phase of the board, so the
+evaluation changes a little with every piece traded instead of jumping between game stages.
+*/
+int taper(Board board, int middlegame, int endgame) {
+    int phase = (board->phase < PHASE_MAX) ? board->phase : PHASE_MAX; // promotions can exceed it
+    return (middlegame * phase + endgame * (PHASE_MAX - phase)) / PHASE_MAX;
 }
 
-// Check if a pawn is isolated
-int isBackwardPawn(unsigned long long pawnBitboard, int square, char color) {
-    int file = square % 8;
-    int rank = square / 8;
-
-    int advanceRank = (color == 'w') ? rank + 1 : rank - 1;
-
-    if (advanceRank < 0 || advanceRank > 7) return 0; // If out of bounds, it's not backward.
-
-    // Get bitboards for same file and adjacent files
-    unsigned long long sameFile = 1ULL << (advanceRank * 8 + file);
-    unsigned long long leftFile = (file > 0) ? 1ULL << (advanceRank * 8 + file - 1) : 0;
-    unsigned long long rightFile = (file < 7) ? 1ULL << (advanceRank * 8 + file + 1) : 0;
-
-    // Check if there are friendly pawns ahead in the same file or adjacent files
-    unsigned long long ahead = pawnBitboard & (sameFile | leftFile | rightFile);
-    
-    return !ahead; // Return true (1) if no supporting pawns, false (0) otherwise.
+// Evaluate the position based on piece-square tables (kept up to date by makeMove)
+int evaluatePosition(Board board){
+    int score = taper(board, board->psqMg, board->psqEg);
+    return (board->toMove == 'w') ? score : -score;
 }
 
-// Evaluate the pawn structure based on pawn support
-int PawnSupport(Board board){
-    int score = 0;
-    int player = (board->toMove == 'w') ? 1 : -1;
-
-    // Isolated pawns
-    unsigned long long whitePawns = board->bitboards[WHITE_PAWNS];
-    unsigned long long blackPawns = board->bitboards[BLACK_PAWNS];
-
-    for (int square = 63; square > -1; square--) {
-        if (IS_BIT_SET(whitePawns, square)) {
-            if(IS_BIT_SET(whitePawns, square - 7) || IS_BIT_SET(whitePawns, square - 9)){
-                score += 15;
-            }
-        }
-        if (IS_BIT_SET(blackPawns, square)) {
-            if(IS_BIT_SET(blackPawns, square + 7) || IS_BIT_SET(blackPawns, square + 9)){
-                score -= 15;
-            }
-        }
-    }
-
-    if (player == -1) score = -score;
-
-    return score;
-}
-
-// Check if a pawn is isolated
+// Evaluate the pawn structure (cached in the pawn hash table, see pawns.c)
 int evaluatePawnStructures(Board board){
-    int score = 0;
-    int player = (board->toMove == 'w') ? 1 : -1;
-
-    // Isolated pawns
-    unsigned long long whitePawns = board->bitboards[WHITE_PAWNS];
-    unsigned long long blackPawns = board->bitboards[BLACK_PAWNS];
+    const PawnEntry *pawns = probePawns(board);
+    int score = taper(board, pawns->mg, pawns->eg);
+    return (board->toMove == 'w') ? score : -score;
+}
 
-    for (int square = 0; square < 64; square++) {
-        if (IS_BIT_SET(whitePawns, square)) {
-            if (isBackwardPawn(whitePawns, square, 'w')) {
-                score -= 10;
-            }
-        }
-        if (IS_BIT_SET(blackPawns, square)) {
-            if (isBackwardPawn(blackPawns, square, 'b')) {
-                score += 10;
+/*
+@brief: fills the squares every bitboard of pieces attacks, pawns all at once by shifting
+their bitboard, other pieces from the attack tables with the board's occupancy.
+*/
+void computeAttackMaps(Board board, AttackMaps *maps) {
+    unsigned long long occupancy = 0ULL;
+    for (int piece = 0; piece < 12; piece++) occupancy |= board->bitboards[piece];
+
+    unsigned long long whitePawns = board->bitboards[WHITE_PAWNS], blackPawns = board->bitboards[BLACK_PAWNS];
+    maps->byPiece[WHITE_PAWNS] = ((whitePawns >> 9) & ~FILE_H) | ((whitePawns >> 7) & ~FILE_A);
+    maps->byPiece[BLACK_PAWNS] = ((blackPawns << 7) & ~FILE_H) | ((blackPawns << 9) & ~FILE_A);
+
+    for (int piece = 0; piece < 12; piece++) {
+        if (piece % 6 == WHITE_PAWNS) continue;
+        unsigned long long attacks = 0ULL, pieces = board->bitboards[piece];
+        while (pieces) {
+            int square = __builtin_ctzll(pieces);
+            switch (piece % 6) {
+                case WHITE_KNIGHTS: attacks |= knightAttacks[square]; break;
+                case WHITE_BISHOPS: attacks |= bishopAttacks(square, occupancy); break;
+                case WHITE_ROOKS: attacks |= rookAttacks(square, occupancy); break;
+                case WHITE_QUEEN: attacks |= queenAttacks(square, occupancy); break;
+                case WHITE_KING: attacks |= kingAttacks[square]; break;
             }
+            pieces &= pieces - 1;
         }
+        maps->byPiece[piece] = attacks;
     }
 
-    // Adjust bonus for Pawn structure
-    score += PawnSupport(board);
-
-    if (player == -1) score = -score;
-
-    return score;
+    maps->bySide[WHITE] = maps->bySide[BLACK] = 0ULL;
+    for (int piece = 0; piece < 6; piece++) {
+        maps->bySide[WHITE] |= maps->byPiece[piece];
+        maps->bySide[BLACK] |= maps->byPiece[piece + 6];
+    }
 }
 
-
-// Returns the gamestate based on the current board
-int setGameState(Board board){
-    
-    // Get the king's square
-    int kingSquare = getKingSquare(board->bitboards, 'w');
-    int kingSquareB = getKingSquare(board->bitboards, 'b');
-
-    // Endgame considerations
-    int total_pieces = __builtin_popcountll(board->bitboards[WHITE_PAWNS] | board->bitboards[WHITE_ROOKS] |
-                                board->bitboards[WHITE_KNIGHTS] | board->bitboards[WHITE_BISHOPS] |
-                                board->bitboards[WHITE_QUEEN]) +
-                        __builtin_popcountll(board->bitboards[BLACK_PAWNS] | board->bitboards[BLACK_ROOKS] |
-                                board->bitboards[BLACK_KNIGHTS] | board->bitboards[BLACK_BISHOPS] |
-                                board->bitboards[BLACK_QUEEN]);
-    
-    // state considerations
-    if (board->fullmove <= 12 && (kingSquareB == 59 || kingSquareB == 60) && (kingSquare == 3 || kingSquare == 4)) {
-        return 0; // we are in the opening stage
-    } else if(board->fullmove >= 12 && board->fullmove <= 30 && total_pieces > PIECES_ENDGAME) {
-        return 1; // we are in the middle game stage
-    } else if (total_pieces <= PIECES_ENDGAME && board->fullmove >= 30) {
-        return 2; // we re in the endgame now
+/*
+@brief: scores what the pieces of one color do to the other's, with the sign of the color:
+pieces attacked by pawns, rooks and queens attacked by minor pieces, pieces attacked and not
+defended, own pieces defended, and attacks on the squares around the enemy king.
+*/
+static void evaluateThreats(Board board, const AttackMaps *maps, int color, int *mg, int *eg) {
+    static const int kingZoneWeights[6] = KING_ZONE_WEIGHTS;
+    int us = (color == WHITE) ? 0 : 6, them = 6 - us, sign = (color == WHITE) ? 1 : -1;
+
+    // Pieces other than pawns and the king, the ones worth threatening and defending.
+    unsigned long long ours = 0ULL, theirs = 0ULL;
+    for (int type = WHITE_ROOKS; type <= WHITE_QUEEN; type++) {
+        ours |= board->bitboards[us + type];
+        theirs |= board->bitboards[them + type];
+    }
+    unsigned long long majors = board->bitboards[them + WHITE_ROOKS] | board->bitboards[them + WHITE_QUEEN];
+
+    int score = THREAT_BY_PAWN * __builtin_popcountll(theirs & maps->byPiece[us + WHITE_PAWNS])
+              + THREAT_BY_MINOR * __builtin_popcountll(majors & (maps->byPiece[us + WHITE_KNIGHTS] | maps->byPiece[us + WHITE_BISHOPS]))
+              + HANGING_PIECE * __builtin_popcountll(theirs & maps->bySide[color] & ~maps->bySide[!color])
+              + DEFENDED_PIECE * __builtin_popcountll(ours & maps->bySide[color]);
+
+    // The enemy king's square and the ones around it, attacked by each kind of piece.
+    int kingSquare = __builtin_ctzll(board->bitboards[them + WHITE_KING]);
+    unsigned long long zone = kingAttacks[kingSquare] | (1ULL << kingSquare);
+    int kingAttack = 0;
+    for (int type = 0; type < 6; type++) {
+        kingAttack += kingZoneWeights[type] * __builtin_popcountll(zone & maps->byPiece[us + type]);
     }
-    return 1;
 
+    *mg += sign * (score + kingAttack);
+    *eg += sign * score;
 }
 
+// Evaluate the threats between the pieces, from the attack maps of both colors
+int evaluateAttacks(Board board){
+    AttackMaps maps;
+    computeAttackMaps(board, &maps);
 
-// Returns the value the enemy piece that claim a square
-int evaluatePieceSquare(Board board, int square, int player){
-    int score = 0;
+    int mg = 0, eg = 0;
+    evaluateThreats(board, &maps, WHITE, &mg, &eg);
+    evaluateThreats(board, &maps, BLACK, &mg, &eg);
 
-    if (player == -1){
-        for (int piece = 6; piece < 12; piece++) {
-            if(piece == BLACK_KNIGHTS) continue;
-            if (IS_BIT_SET(board->bitboards[piece], square)) {
-                score += pieceValues[piece];
-            }
-        }
-    } else if(player == 1){ 
-        for (int piece = 0; piece < 6; piece++) {
-            if(piece == WHITE_KNIGHTS) continue;
-            if (IS_BIT_SET(board->bitboards[piece], square)) {
-                score -= pieceValues[piece];
-            }
-        }
-    }  
-    return score;
+    int score = taper(board, mg, eg);
+    return (board->toMove == 'w') ? score : -score;
 }
 
-// Function that returns the first vertical or horizontal square that is occupied by a piece
-int getSquare(Board board, int square, int direction){
-    int Square = square + direction;
-    while (Square >= 0 && Square < 64) {
-        if (whatPiece(board->bitboards, Square) != -1) {
-            return Square;
-        }
-        Square += direction;
-    }
-    return -1;
+void evalCacheClear(void) {
+    for (int i = 0; i < EVAL_CACHE_SIZE; i++) atomic_store_explicit(&evalCache[i], 0ULL, memory_order_relaxed);
 }
 
-// Function that returns the amount of knights that threaten a square 
-// A knight on a best case scenario claims 8 possible squares
-int getKnightThreats(Board board, int square){
-    int threats = 0;
-    int player = (board->toMove == 'w') ? 1 : -1;
+void evalCacheStats(unsigned long long *probes, unsigned long long *hits) {
+    *probes = atomic_load_explicit(&cacheProbes, memory_order_relaxed);
+    *hits = atomic_load_explicit(&cacheHits, memory_order_relaxed);
+}
 
-    int directions[8] = {6, 10, 15, 17, -6, -10, -15, -17};
-    for(int i = 0; i < 8; i++){
-        if(whatPiece(board->bitboards, square + directions[i]) == player * WHITE_KNIGHTS){
-            threats++;
-        }
+// @brief: counts a probe of the evaluation cache, and adds the thread's counts every few probes.
+static void countProbe(int hit) {
+    localHits += hit;
+    if (++localProbes == EVAL_CACHE_FLUSH) {
+        atomic_fetch_add_explicit(&cacheProbes, localProbes, memory_order_relaxed);
+        atomic_fetch_add_explicit(&cacheHits, localHits, memory_order_relaxed);
+        localProbes = localHits = 0;
     }
-
-    return threats;
 }
 
-// Function that returns the value of the vertical and horizontal threats to a square
-int getThreats(Board board){
+// @brief: evaluates the board with the evaluation in use: the network or the classical terms.
+static int evaluateUncached(Board board) {
     int score = 0;
-    int knightThreats = 0;
-    int directions[8] = {1, -1, 8, -8, 7, -7, 9, -9};
-
-    for (int square = 0; square < 64; square++) {
-        knightThreats = getKnightThreats(board, square);
-        for(int i = 0; i < 8; i++){
-            int Square = getSquare(board, square, directions[i]);
-            if(Square != -1){
-                score += evaluatePieceSquare(board, Square, -1);
-            }
-        }
-    }
 
-    score -= knightThreats*10;
+    // The neural evaluation replaces all of the terms below when it is in use
+    if (nnueInUse) return nnueEvaluate(board);
 
-    return score;
-}
-
-// Function that calculates the value of the pieces that guard a square
-int getDefenders(Board board){
-    int score = 0;
-    int player = (board->toMove == 'w') ? 1 : -1;
-    int directions[8] = {1, -1, 8, -8, 7, -7, 9, -9};
-
-    for (int square = 0; square < 64; square++) {
-        for(int i = 0; i < 8; i++){
-            int Square = getSquare(board, square, directions[i]);
-            if(Square != -1){
-                score += evaluatePieceSquare(board, Square, 1);
-            }
-        }
-        score += evaluatePieceSquare(board, square, player);
-    }
+    // Evaluate the material balance
+    score += evaluateMaterial(board);
 
-    return score;
-}
+    // Evaluate the position
+    score += evaluatePosition(board);
 
-// Function that calculates the value of the pieces that attack a square
-// And defends the square along with the value of the piece on it
-int evaluateSquare(Board board){
-    int score = 0;
+    // Evaluate the pawn structures
+    score += evaluatePawnStructures(board);
 
-    score += getThreats(board);
-    score += getDefenders(board);
+    // Evaluate the threats and the attacks on the kings
+    score += evaluateAttacks(board);
 
     return score;
 }
 
 // Evaluate the board score from the perspective of the current player
 int evaluateBitboard(Board board) {
-    int score = 0;
-
-    // Set the game state
-    int gameState = setGameState(board);
-
-    // Evaluate the material balance
-    score += evaluateMaterial(board);
-
-    // Evaluate the position
-    score += evaluatePosition(board, gameState);
-
-    // Evaluate the pawn structures
-    score += evaluatePawnStructures(board);
-    
-    // Attacked squares penalty currently working on it
-    //score += evaluateSquare(board);
+    _Atomic unsigned long long *entry = &evalCache[board->key & (EVAL_CACHE_SIZE - 1)];
+    unsigned long long word = atomic_load_explicit(entry, memory_order_relaxed);
+    if (word && (word & EVAL_CACHE_TAG) == (board->key & EVAL_CACHE_TAG)) {
+        countProbe(1);
+        return (short int)(unsigned short int)(word & ~EVAL_CACHE_TAG);
+    }
+    countProbe(0);
 
+    int score = evaluateUncached(board);
+    if (score > SHRT_MAX) score = SHRT_MAX;
+    if (score < -SHRT_MAX) score = -SHRT_MAX;
+    word = (board->key & EVAL_CACHE_TAG) | (unsigned short int)score;
+    atomic_store_explicit(entry, word, memory_order_relaxed);
     return score;
-}
\ No newline at end of file
+}
@@ -12,13 +12,57 @@
 #define K_VALUE 500 // king (huge value to protect at all costs)
 #define BONUS_K_VALUE 200 // bonus points for king in special scenarios like when ruining castling
 
-//Global attacked square penalty
-#define ATTACKED_SQUARE_PENALTY 30
+// Threats, from the attack maps: bonuses for the attacker
+#define THREAT_BY_PAWN 15 // a pawn attacks a piece
+#define THREAT_BY_MINOR 10 // a knight or bishop attacks a rook or queen
+#define HANGING_PIECE 10 // a piece is attacked and not defended
+#define DEFENDED_PIECE 2 // bonus for a piece defended by its own side
+// Attacks on the squares around the enemy king, by attacking piece type (middlegame only)
+#define KING_ZONE_WEIGHTS {0, 3, 2, 2, 5, 0}
 
-// A Number that if there are less pieces left for any player, endgame strategy activates
-#define PIECES_ENDGAME 17
+// Game phase: every knight and bishop left on the board counts 1, every rook 2 and every queen 4,
+// so the starting position has PHASE_MAX and kings and pawns alone have 0. Scores slide from
+// their middlegame to their endgame value as the phase goes down.
+#define PHASE_MAX 24
 
 // Function to evaluate a single move
 int evaluateBitboard(Board board);
 
+// Entries of the evaluation cache (a power of two), one 64-bit word each
+#define EVAL_CACHE_SIZE (1 << 16)
+// Probes a thread counts before adding them to the shared hit-rate counters
+#define EVAL_CACHE_FLUSH 1024
+
+// Forgets every cached evaluation, e.g. when the evaluation itself changes
+void evalCacheClear(void);
+
+// Probes and hits of the evaluation cache since the program started, all threads together
+// (each thread adds its counts in batches of EVAL_CACHE_FLUSH, so the latest are missing)
+void evalCacheStats(unsigned long long *probes, unsigned long long *hits);
+
+// Squares attacked by the pieces of a position, built once per evaluation
+typedef struct attackMaps {
+    unsigned long long byPiece[12]; // attacked by any piece of that bitboard
+    unsigned long long bySide[2]; // attacked by any piece of that color
+} AttackMaps;
+
+// Fills the attack maps of a position
+void computeAttackMaps(Board board, AttackMaps *maps);
+
+// Signed value of every piece (negative for black) and piece-square scores of every piece on
+// every square, middlegame and endgame (negative for black), summed up in the board by makeMove
+extern int pieceValues[12];
+extern int pieceSquareMg[12][64];
+extern int pieceSquareEg[12][64];
+extern int piecePhase[12];
+
+// Fills the piece-square scores from the tables; cheap to call again
+void initPieceSquare(void);
+
+// Blends a middlegame and an endgame score by the game phase of the board
+int taper(Board board, int middlegame, int endgame);
+
+// Computes the material, piece-square and phase sums of a position from scratch
+void computePieceSquare(Board board);
+
 #endif
\ No newline at end of file
@@ -2,8 +2,10 @@
 #define INIT
 
 #define BOARD_SIZE 8
-#define MAX_HISTORY 100
-#define MAX_DEPTH 4
+#define MAX_HISTORY 1024 // moves that can be taken back with unmakeMove
+#define MAX_DEPTH 64 // deepest iteration of the iterative deepening
+#define MAX_PLY 128 // deepest distance from the root the search keeps track of
+#define NNUE_HIDDEN 256 // neurons of the first layer of the neural evaluation (see nnue.c)
 
 #define MAX_MOVE_LENGTH 10 // d7xe8=B++ is a valid move notation
 #define EXIT_SUCCESS 0
@@ -20,16 +22,24 @@
 // Checking if a bit is set
 #define IS_BIT_SET(bitboard, square) ((bitboard) & (1ULL << (square)))
 
-// Mapping squares (0-63 for A1-H8).
+// File (0 = a) and rank (0 = rank 1) of a square index.
+#define FILE_OF(square) ((square) % 8)
+#define RANK_OF(square) (7 - (square) / 8)
+
+// Squares of the a and h files, to mask out what a sideways shift of a bitboard wraps around.
+#define FILE_A 0x0101010101010101ULL
+#define FILE_H 0x8080808080808080ULL
+
+// Mapping squares (0-63 for A8-H1), matching the order parseFenRec fills the bitboards in.
 enum squares {
-    A1, B1, C1, D1, E1, F1, G1, H1,
-    A2, B2, C2, D2, E2, F2, G2, H2,
-    A3, B3, C3, D3, E3, F3, G3, H3,
-    A4, B4, C4, D4, E4, F4, G4, H4,
-    A5, B5, C5, D5, E5, F5, G5, H5,
-    A6, B6, C6, D6, E6, F6, G6, H6,
+    A8, B8, C8, D8, E8, F8, G8, H8,
     A7, B7, C7, D7, E7, F7, G7, H7,
-    A8, B8, C8, D8, E8, F8, G8, H8
+    A6, B6, C6, D6, E6, F6, G6, H6,
+    A5, B5, C5, D5, E5, F5, G5, H5,
+    A4, B4, C4, D4, E4, F4, G4, H4,
+    A3, B3, C3, D3, E3, F3, G3, H3,
+    A2, B2, C2, D2, E2, F2, G2, H2,
+    A1, B1, C1, D1, E1, F1, G1, H1
 };
 
 // Define piece constants for indexing the bitboards (0-indexed).
@@ -38,15 +48,44 @@ enum {
     BLACK_PAWNS, BLACK_ROOKS, BLACK_KNIGHTS, BLACK_BISHOPS, BLACK_QUEEN, BLACK_KING
 };
 
+// Castling rights, as bits of board->castling.
+#define CASTLE_WHITE_KING 1
+#define CASTLE_WHITE_QUEEN 2
+#define CASTLE_BLACK_KING 4
+#define CASTLE_BLACK_QUEEN 8
+#define CASTLE_ALL 15
+
+// Value of board->pass when en passant is not possible.
+#define NO_EN_PASSANT -1
+
+// State that a move destroys and unmakeMove has to restore
+// (the captured piece is part of the move itself).
+typedef struct undo {
+    unsigned long long key; // position key before the move
+    unsigned long long pawnKey;
+    unsigned int move; // the packed move that was played
+    unsigned char castling;
+    signed char pass;
+    unsigned short int halfmove;
+    int material, psqMg, psqEg, phase; // evaluation sums before the move
+} Undo;
+
 typedef struct board {
     unsigned long long bitboards[12]; // One bitboard per piece type and color, 12 in total
     char toMove; // next player's letter ('w' or 'b')
-    char castling[5]; // whether castling is possible or not
-    char pass[3]; //  whether en passant is possible or not
-    // (note: we need 3 spots because. when there is en passant availability, the only thing
-    // given is the destination square).
+    unsigned char castling; // castling rights still available (CASTLE_* bits)
+    signed char pass; // en passant target square, or NO_EN_PASSANT
     unsigned short int halfmove; // counter for halfmoves
     unsigned short int fullmove; // counter for full moves
+    unsigned long long key; // Zobrist key of the position, kept up to date by makeMove
+    unsigned long long pawnKey; // Zobrist key of the pawns alone, same
+    int material; // white minus black piece values, kept up to date by makeMove
+    int psqMg, psqEg; // white minus black piece-square scores (middlegame, endgame), same
+    int phase; // game phase left by the pieces on the board (see evaluate.h), same
+    short int accumulator[2][NNUE_HIDDEN]; // first layer of the neural evaluation from each color's side,
+                                           // kept up to date by makeMove while it is in use
+    int ply; // number of moves on the undo stack
+    Undo history[MAX_HISTORY]; // undo stack filled by makeMove
 } * Board;
 
 void debugPrint(const char *format, ...);
@@ -0,0 +1,134 @@
+/**
+ * @file move.c
+ * @brief This file contains the helpers for the packed move representation:
+ * filling move lists and converting moves from and to algebraic notation.
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <ctype.h>
+
+#include "init.h"
+#include "move.h"
+#include "bitboard.h"
+
+// Piece letters indexed by piece type (WHITE_PAWNS ... WHITE_KING).
+static const char PIECE_LETTERS[] = "PRNBQK";
+
+// @brief: adds one move for every destination set in targets, all from the same square.
+void addTargetMoves(MoveList *list, Board board, int from, int piece, unsigned long long targets, int flags) {
+    while (targets) {
+        int to = __builtin_ctzll(targets);
+        int captured = (flags & MOVE_FLAG_CAPTURE) ? whatPieceBit(board->bitboards, to) : NO_PIECE;
+        ADD_MOVE(list, ENCODE_MOVE(from, to, piece, captured, 0, flags));
+        targets &= targets - 1;
+    }
+}
+
+// @brief: adds the four promotion choices of a pawn move (queen and knight first).
+void addPromotions(MoveList *list, int from, int to, int piece, int captured, int flags) {
+    int base = (piece == WHITE_PAWNS) ? WHITE_PAWNS : BLACK_PAWNS;
+    ADD_MOVE(list, ENCODE_MOVE(from, to, piece, captured, base + WHITE_QUEEN, flags));
+    ADD_MOVE(list, ENCODE_MOVE(from, to, piece, captured, base + WHITE_KNIGHTS, flags));
+    ADD_MOVE(list, ENCODE_MOVE(from, to, piece, captured, base + WHITE_ROOKS, flags));
+    ADD_MOVE(list, ENCODE_MOVE(from, to, piece, captured, base + WHITE_BISHOPS, flags));
+}
+
+/*
+@brief: finds the move of a legal move list that a SAN string refers to.
+Accepts check/annotation suffixes, "0-0" as well as "O-O", and redundant disambiguation
+(e.g. "Nb1c3").
+
+return: the matching move, or NO_MOVE if the string matches no legal move.
+*/
+Move sanToMove(Board board, const char *san, const MoveList *legal) {
+    char text[MAX_MOVE_LENGTH + 1];
+    int length = 0;
+
+    // Copy the move without check or annotation symbols.
+    for (int i = 0; san[i] != '\0' && length < MAX_MOVE_LENGTH; i++) {
+        if (!strchr("+#!?", san[i])) text[length++] = san[i];
+    }
+    text[length] = '\0';
+    if (length < 2) return NO_MOVE;
+
+    // Castling.
+    if (text[0] == 'O' || text[0] == '0') {
+        int targetFile = (length >= 5) ? 2 : 6;
+        for (int i = 0; i < legal->count; i++) {
+            Move move = legal->moves[i];
+            if ((MOVE_FLAGS(move) & MOVE_FLAG_CASTLE) && FILE_OF(MOVE_TO(move)) == targetFile) return move;
+        }
+        return NO_MOVE;
+    }
+
+    // Moving piece.
+    int type = WHITE_PAWNS, start = 0;
+    const char *letter = strchr(PIECE_LETTERS, text[0]);
+    if (letter && text[0] != 'P') {
+        type = letter - PIECE_LETTERS;
+        start = 1;
+    }
+
+    // Promotion ("e8=Q", or "e8Q" without the '=').
+    int promotion = -1;
+    char *equals = strchr(text, '=');
+    if (equals) {
+        if (!equals[1] || !(letter = strchr(PIECE_LETTERS, equals[1]))) return NO_MOVE;
+        promotion = letter - PIECE_LETTERS;
+        length = equals - text;
+    } else if (type == WHITE_PAWNS && isupper((unsigned char)text[length - 1])) {
+        if (!(letter = strchr(PIECE_LETTERS, text[length - 1]))) return NO_MOVE;
+        promotion = letter - PIECE_LETTERS;
+        length--;
+    }
+    if (length - start < 2) return NO_MOVE;
+
+    // Destination square.
+    char file = text[length - 2], rank = text[length - 1];
+    if (file < 'a' || file > 'h' || rank < '1' || rank > '8') return NO_MOVE;
+    int to = (7 - (rank - '1')) * 8 + (file - 'a');
+
+    // Optional origin file and/or rank.
+    int fromFile = -1, fromRank = -1;
+    for (int i = start; i < length - 2; i++) {
+        if (text[i] >= 'a' && text[i] <= 'h') fromFile = text[i] - 'a';
+        else if (text[i] >= '1' && text[i] <= '8') fromRank = text[i] - '1';
+    }
+
+    int base = (board->toMove == 'w') ? WHITE_PAWNS : BLACK_PAWNS;
+    for (int i = 0; i < legal->count; i++) {
+        Move move = legal->moves[i];
+        if (MOVE_PIECE(move) != base + type || MOVE_TO(move) != to) continue;
+        if (MOVE_FLAGS(move) & MOVE_FLAG_CASTLE) continue;
+        if (fromFile != -1 && FILE_OF(MOVE_FROM(move)) != fromFile) continue;
+        if (fromRank != -1 && RANK_OF(MOVE_FROM(move)) != fromRank) continue;
+        if (promotion == -1 ? MOVE_PROMOTION(move) != 0 : MOVE_PROMOTION(move) != base + promotion) continue;
+        return move;
+    }
+    return NO_MOVE;
+}
+
+/*
+@brief: writes a move in coordinate notation ("e2e4", "e1g1" for castling, "e7e8q").
+The buffer must hold at least 6 bytes.
+*/
+void moveToUci(Move move, char *buffer) {
+    int from = MOVE_FROM(move), to = MOVE_TO(move);
+    buffer[0] = 'a' + FILE_OF(from);
+    buffer[1] = '1' + RANK_OF(from);
+    buffer[2] = 'a' + FILE_OF(to);
+    buffer[3] = '1' + RANK_OF(to);
+    buffer[4] = MOVE_PROMOTION(move) ? tolower((unsigned char)PIECE_LETTERS[MOVE_PROMOTION(move) % 6]) : '\0';
+    buffer[5] = '\0';
+}
+
+// @brief: finds the legal move written in UCI notation; returns NO_MOVE if there is none.
+Move uciToMove(const char *uci, const MoveList *legal) {
+    char buffer[6];
+    for (int i = 0; i < legal->count; i++) {
+        moveToUci(legal->moves[i], buffer);
+        if (strcmp(buffer, uci) == 0) return legal->moves[i];
+    }
+    return NO_MOVE;
+}
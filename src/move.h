@@ -0,0 +1,54 @@
+#ifndef MOVE
+#define MOVE
+
+#include "init.h"
+
+// A move packed into 32 bits:
+// bits 0-5 origin square, 6-11 destination square, 12-15 moving piece,
+// 16-19 captured piece (NO_PIECE if none), 20-23 promotion piece (0 if none),
+// 24-27 move flags.
+typedef unsigned int Move;
+
+#define NO_MOVE 0
+#define NO_PIECE 12
+
+// Move flags
+#define MOVE_FLAG_CAPTURE 1
+#define MOVE_FLAG_DOUBLE_PUSH 2
+#define MOVE_FLAG_EN_PASSANT 4
+#define MOVE_FLAG_CASTLE 8
+
+#define ENCODE_MOVE(from, to, piece, captured, promotion, flags) \
+    ((Move)(from) | ((Move)(to) << 6) | ((Move)(piece) << 12) | \
+     ((Move)(captured) << 16) | ((Move)(promotion) << 20) | ((Move)(flags) << 24))
+
+#define MOVE_FROM(move) ((int)((move) & 0x3F))
+#define MOVE_TO(move) ((int)(((move) >> 6) & 0x3F))
+#define MOVE_PIECE(move) ((int)(((move) >> 12) & 0xF))
+#define MOVE_CAPTURED(move) ((int)(((move) >> 16) & 0xF))
+#define MOVE_PROMOTION(move) ((int)(((move) >> 20) & 0xF))
+#define MOVE_FLAGS(move) ((int)(((move) >> 24) & 0xF))
+
+// Enough for any legal chess position (the known maximum is 218).
+#define MAX_MOVES 256
+
+// Fixed-size move list, meant to live on the stack.
+typedef struct moveList {
+    Move moves[MAX_MOVES];
+    int count;
+} MoveList;
+
+#define ADD_MOVE(list, move) ((list)->moves[(list)->count++] = (move))
+
+// Functions to fill move lists
+void addTargetMoves(MoveList *list, Board board, int from, int piece, unsigned long long targets, int flags);
+void addPromotions(MoveList *list, int from, int to, int piece, int captured, int flags);
+
+// Finds the legal move a string in standard algebraic notation (SAN) refers to
+Move sanToMove(Board board, const char *san, const MoveList *legal);
+
+// Long algebraic (coordinate) notation as used by UCI, e.g. "e2e4" or "e7e8q"
+void moveToUci(Move move, char *buffer);
+Move uciToMove(const char *uci, const MoveList *legal);
+
+#endif
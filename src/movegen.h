@@ -2,17 +2,16 @@
 #define MOVEGEN
 
 #include "init.h"
+#include "move.h"
 #include "capture.h" // Library used to generate attack moves
 
-// Function to generate Passive Piece Moves
-char *generatePawnMoves(Board board);
-char *generateBishopMoves(Board board);
-char *generateKnightMoves(Board board);
-char *generateRookMoves(Board board);
-char *generateQueenMoves(Board board);
-char *generateKingMoves(Board board);
-char *generateAllMoves(Board board);
-int updateEnPassant(Board board, const char *move);
-char *generateMoveMoves(Board board, const char *moves);
+// Function to generate Passive Piece Moves (legal moves only)
+void generatePawnMoves(Board board, MoveList *list, const CheckInfo *info);
+void generateBishopMoves(Board board, MoveList *list, const CheckInfo *info);
+void generateKnightMoves(Board board, MoveList *list, const CheckInfo *info);
+void generateRookMoves(Board board, MoveList *list, const CheckInfo *info);
+void generateQueenMoves(Board board, MoveList *list, const CheckInfo *info);
+void generateKingMoves(Board board, MoveList *list, const CheckInfo *info);
+void generateAllMoves(Board board, MoveList *list, const CheckInfo *info);
 
-#endif
\ No newline at end of file
+#endif
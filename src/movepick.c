@@ -0,0 +1,130 @@
+/**
+ * @file movepick.c
+ * @brief This file contains the move ordering of the search: the moves of a position are
+ * handed out in stages, best first, so that alpha-beta finds its cutoffs early.
+ * The stages are the transposition table move, winning captures and queen promotions
+ * (most valuable victim, least valuable attacker first), killer moves, the other quiet
+ * moves by history score, and last losing captures and underpromotions.
+ */
+
+#include "init.h"
+#include "movepick.h"
+#include "bitboard.h"
+#include "capture.h"
+#include "movegen.h"
+#include "attacks.h"
+
+// Ordering values of the piece types (WHITE_PAWNS ... WHITE_KING)
+static const int ORDER_VALUES[6] = {1, 5, 3, 3, 9, 20};
+
+// Score bands of the stages, far enough apart that they never overlap
+#define HASH_MOVE_SCORE 4000000
+#define GOOD_CAPTURE_SCORE 3000000
+#define KILLER_SCORE 2000000
+#define BAD_CAPTURE_SCORE -2000000
+#define UNDERPROMOTION_SCORE -3000000
+#define MAX_MVV_LVA (2 * 9 * 32) // a queen taken by a promotion: more than any capture adds to its band
+
+#define IS_QUIET(move) (MOVE_CAPTURED(move) == NO_PIECE && !MOVE_PROMOTION(move))
+
+/*
+@brief: orders a capture or promotion. A capture is winning if it takes a piece worth at least
+as much as the capturing one, or if the exchanges it starts do not lose material (see).
+*/
+static int scoreTactical(Board board, Move move) {
+    int attacker = ORDER_VALUES[MOVE_PIECE(move) % 6];
+    int promotion = MOVE_PROMOTION(move);
+    if (promotion && promotion % 6 != WHITE_QUEEN) return UNDERPROMOTION_SCORE;
+
+    int victim = (MOVE_CAPTURED(move) != NO_PIECE) ? ORDER_VALUES[MOVE_CAPTURED(move) % 6] : 0;
+    if (promotion) victim += ORDER_VALUES[WHITE_QUEEN];
+    int mvvLva = victim * 32 - attacker;
+
+    if (victim >= attacker || see(board, move) >= 0) return GOOD_CAPTURE_SCORE + mvvLva;
+    return BAD_CAPTURE_SCORE + mvvLva;
+}
+
+void initMovePicker(MovePicker *picker, Board board, Move hashMove, const Heuristics *heuristics, int ply) {
+    CheckInfo info;
+    computeCheckInfo(board, &info);
+    picker->list.count = 0;
+    picker->next = 0;
+    generateAllMoves(board, &picker->list, &info);
+
+    for (int i = 0; i < picker->list.count; i++) {
+        Move move = picker->list.moves[i];
+        int score;
+        if (move == hashMove) score = HASH_MOVE_SCORE;
+        else if (!IS_QUIET(move)) score = scoreTactical(board, move);
+        else if (move == heuristics->killers[ply][0]) score = KILLER_SCORE + 1;
+        else if (move == heuristics->killers[ply][1]) score = KILLER_SCORE;
+        else score = heuristics->history[MOVE_PIECE(move)][MOVE_TO(move)];
+        picker->scores[i] = score;
+    }
+}
+
+void initCapturePicker(MovePicker *picker, Board board) {
+    CheckInfo info;
+    computeCheckInfo(board, &info);
+    picker->list.count = 0;
+    picker->next = 0;
+    generateAllCaptures(board, &picker->list, &info);
+
+    for (int i = 0; i < picker->list.count; i++) {
+        picker->scores[i] = scoreTactical(board, picker->list.moves[i]);
+    }
+}
+
+/*
+@brief: hands out the best scored move not handed out yet (one selection sort step, so
+the moves after a cutoff are never sorted at all).
+*/
+Move nextMove(MovePicker *picker) {
+    if (picker->next >= picker->list.count) return NO_MOVE;
+
+    int best = picker->next;
+    for (int i = best + 1; i < picker->list.count; i++) {
+        if (picker->scores[i] > picker->scores[best]) best = i;
+    }
+
+    Move move = picker->list.moves[best];
+    int score = picker->scores[best];
+    picker->list.moves[best] = picker->list.moves[picker->next];
+    picker->scores[best] = picker->scores[picker->next];
+    picker->list.moves[picker->next] = move;
+    picker->scores[picker->next++] = score;
+    return move;
+}
+
+int pickedLosing(const MovePicker *picker) {
+    return picker->next > 0 && picker->scores[picker->next - 1] <= BAD_CAPTURE_SCORE + MAX_MVV_LVA;
+}
+
+// @brief: moves a history score towards +-HISTORY_MAX, less the closer it already is.
+static void addHistory(int *entry, int bonus) {
+    int magnitude = bonus < 0 ? -bonus : bonus;
+    *entry += bonus - *entry * magnitude / HISTORY_MAX;
+}
+
+void updateQuietHeuristics(Heuristics *heuristics, Move move, const Move *tried, int triedCount, int depth, int ply) {
+    if (ply < MAX_PLY && heuristics->killers[ply][0] != move) {
+        heuristics->killers[ply][1] = heuristics->killers[ply][0];
+        heuristics->killers[ply][0] = move;
+    }
+
+    // Reward the move that refuted the position, and penalize the quiet moves tried before it.
+    int bonus = (depth >= 8) ? HISTORY_MAX / 8 : 32 * depth * depth;
+    addHistory(&heuristics->history[MOVE_PIECE(move)][MOVE_TO(move)], bonus);
+    for (int i = 0; i < triedCount; i++) {
+        if (tried[i] != move && IS_QUIET(tried[i])) {
+            addHistory(&heuristics->history[MOVE_PIECE(tried[i])][MOVE_TO(tried[i])], -bonus);
+        }
+    }
+}
+
+void resetHeuristics(Heuristics *heuristics) {
+    for (int ply = 0; ply < MAX_PLY; ply++) heuristics->killers[ply][0] = heuristics->killers[ply][1] = NO_MOVE;
+    for (int piece = 0; piece < 12; piece++) {
+        for (int square = 0; square < 64; square++) heuristics->history[piece][square] /= 2;
+    }
+}
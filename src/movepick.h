@@ -0,0 +1,40 @@
+#ifndef MOVEPICK
+#define MOVEPICK
+
+#include "init.h"
+#include "move.h"
+
+// Largest history score, kept well below the killer and capture bands
+#define HISTORY_MAX 16384
+
+// What the search has learned about quiet moves so far
+typedef struct heuristics {
+    Move killers[MAX_PLY][2]; // two latest quiet moves that caused a beta cutoff at each ply
+    int history[12][64]; // how well quiet moves of a piece to a square did, by [piece][to]
+} Heuristics;
+
+// Legal moves of a position and their ordering scores, handed out best first
+typedef struct movePicker {
+    MoveList list;
+    int scores[MAX_MOVES];
+    int next; // moves before this index were already handed out
+} MovePicker;
+
+// Generates the legal moves (or captures only) of a position and orders them
+void initMovePicker(MovePicker *picker, Board board, Move hashMove, const Heuristics *heuristics, int ply);
+void initCapturePicker(MovePicker *picker, Board board);
+
+// Returns the next move to search, or NO_MOVE when none are left
+Move nextMove(MovePicker *picker);
+
+// Whether the move nextMove handed out last is a losing capture or an underpromotion
+// (all of them come after every other move)
+int pickedLosing(const MovePicker *picker);
+
+// Updates killers and history after a quiet move caused a beta cutoff
+void updateQuietHeuristics(Heuristics *heuristics, Move move, const Move *tried, int triedCount, int depth, int ply);
+
+// Ages the history between searches and forgets the killers
+void resetHeuristics(Heuristics *heuristics);
+
+#endif
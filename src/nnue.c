@@ -0,0 +1,261 @@
+/**
+ * @file nnue.c
+ * @brief This file contains the neural evaluation, an efficiently updatable network: every piece
+ * on every square adds one column of weights to the first layer (the accumulator), so a move only
+ * adds and subtracts the columns of the pieces it moves, and the board keeps the accumulators up
+ * to date in makeMove. The rest of the network is a single output neuron over the clipped
+ * accumulators of both sides. The inner loops run with AVX2 or SSE4.1 when the processor has
+ * them, chosen at run time, and as plain C otherwise.
+ */
+
+#include <stdio.h>
+#include <string.h>
+
+#include "init.h"
+#include "nnue.h"
+#include "attacks.h"
+#include "evaluate.h"
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define NNUE_X86 1
+#else
+#define NNUE_X86 0
+#endif
+
+int nnueInUse = 0;
+
+static short int featureWeights[NNUE_FEATURES][NNUE_HIDDEN];
+static short int featureBiases[NNUE_HIDDEN];
+static signed char outputWeights[2][NNUE_HIDDEN]; // side to move, other side
+static int outputBias;
+static int outputScale; // of the file: turns the output into centipawns
+static int loaded = 0;
+
+// Inference kernels, set by selectKernels.
+static void (*addColumn)(short int *accumulator, const short int *column);
+static void (*subtractColumn)(short int *accumulator, const short int *column);
+static int (*dotProduct)(const short int *accumulator, const signed char *weights);
+static const char *kernelName = "scalar";
+
+static void addColumnScalar(short int *accumulator, const short int *column) {
+    for (int i = 0; i < NNUE_HIDDEN; i++) accumulator[i] = (short int)(accumulator[i] + column[i]);
+}
+
+static void subtractColumnScalar(short int *accumulator, const short int *column) {
+    for (int i = 0; i < NNUE_HIDDEN; i++) accumulator[i] = (short int)(accumulator[i] - column[i]);
+}
+
+// @brief: the weighted sum of the clipped accumulator.
+static int dotProductScalar(const short int *accumulator, const signed char *weights) {
+    int sum = 0;
+    for (int i = 0; i < NNUE_HIDDEN; i++) {
+        int value = accumulator[i];
+        if (value < 0) value = 0;
+        if (value > NNUE_ACTIVATION_MAX) value = NNUE_ACTIVATION_MAX;
+        sum += value * weights[i];
+    }
+    return sum;
+}
+
+#if NNUE_X86
+
+__attribute__((target("avx2")))
+static void addColumnAvx2(short int *accumulator, const short int *column) {
+    for (int i = 0; i < NNUE_HIDDEN; i += 16) {
+        __m256i sum = _mm256_add_epi16(_mm256_loadu_si256((const __m256i *)(accumulator + i)),
+                                       _mm256_loadu_si256((const __m256i *)(column + i)));
+        _mm256_storeu_si256((__m256i *)(accumulator + i), sum);
+    }
+}
+
+__attribute__((target("avx2")))
+static void subtractColumnAvx2(short int *accumulator, const short int *column) {
+    for (int i = 0; i < NNUE_HIDDEN; i += 16) {
+        __m256i difference = _mm256_sub_epi16(_mm256_loadu_si256((const __m256i *)(accumulator + i)),
+                                              _mm256_loadu_si256((const __m256i *)(column + i)));
+        _mm256_storeu_si256((__m256i *)(accumulator + i), difference);
+    }
+}
+
+/*
+@brief: the weighted sum of the clipped accumulator, 32 neurons at a time: the accumulator is
+packed to unsigned bytes (saturating below at 0) and capped, then multiplied by the signed byte
+weights in pairs (maddubs, which cannot overflow with values up to 127) and summed to 32 bits.
+*/
+__attribute__((target("avx2")))
+static int dotProductAvx2(const short int *accumulator, const signed char *weights) {
+    const __m256i ones = _mm256_set1_epi16(1), top = _mm256_set1_epi8(NNUE_ACTIVATION_MAX);
+    __m256i sum = _mm256_setzero_si256();
+    for (int i = 0; i < NNUE_HIDDEN; i += 32) {
+        __m256i low = _mm256_loadu_si256((const __m256i *)(accumulator + i));
+        __m256i high = _mm256_loadu_si256((const __m256i *)(accumulator + i + 16));
+        // Packing works within 128-bit lanes; the permutation puts the neurons back in order.
+        __m256i clipped = _mm256_min_epu8(_mm256_packus_epi16(low, high), top);
+        clipped = _mm256_permute4x64_epi64(clipped, 0xD8);
+        __m256i products = _mm256_maddubs_epi16(clipped, _mm256_loadu_si256((const __m256i *)(weights + i)));
+        sum = _mm256_add_epi32(sum, _mm256_madd_epi16(products, ones));
+    }
+    __m128i total = _mm_add_epi32(_mm256_castsi256_si128(sum), _mm256_extracti128_si256(sum, 1));
+    total = _mm_add_epi32(total, _mm_shuffle_epi32(total, 0x4E));
+    total = _mm_add_epi32(total, _mm_shuffle_epi32(total, 0xB1));
+    return _mm_cvtsi128_si32(total);
+}
+
+__attribute__((target("sse4.1")))
+static void addColumnSse41(short int *accumulator, const short int *column) {
+    for (int i = 0; i < NNUE_HIDDEN; i += 8) {
+        __m128i sum = _mm_add_epi16(_mm_loadu_si128((const __m128i *)(accumulator + i)),
+                                    _mm_loadu_si128((const __m128i *)(column + i)));
+        _mm_storeu_si128((__m128i *)(accumulator + i), sum);
+    }
+}
+
+__attribute__((target("sse4.1")))
+static void subtractColumnSse41(short int *accumulator, const short int *column) {
+    for (int i = 0; i < NNUE_HIDDEN; i += 8) {
+        __m128i difference = _mm_sub_epi16(_mm_loadu_si128((const __m128i *)(accumulator + i)),
+                                           _mm_loadu_si128((const __m128i *)(column + i)));
+        _mm_storeu_si128((__m128i *)(accumulator + i), difference);
+    }
+}
+
+// @brief: as dotProductAvx2, 16 neurons at a time.
+__attribute__((target("sse4.1")))
+static int dotProductSse41(const short int *accumulator, const signed char *weights) {
+    const __m128i ones = _mm_set1_epi16(1), top = _mm_set1_epi8(NNUE_ACTIVATION_MAX);
+    __m128i sum = _mm_setzero_si128();
+    for (int i = 0; i < NNUE_HIDDEN; i += 16) {
+        __m128i low = _mm_loadu_si128((const __m128i *)(accumulator + i));
+        __m128i high = _mm_loadu_si128((const __m128i *)(accumulator + i + 8));
+        __m128i clipped = _mm_min_epu8(_mm_packus_epi16(low, high), top);
+        __m128i products = _mm_maddubs_epi16(clipped, _mm_loadu_si128((const __m128i *)(weights + i)));
+        sum = _mm_add_epi32(sum, _mm_madd_epi16(products, ones));
+    }
+    sum = _mm_add_epi32(sum, _mm_shuffle_epi32(sum, 0x4E));
+    sum = _mm_add_epi32(sum, _mm_shuffle_epi32(sum, 0xB1));
+    return _mm_cvtsi128_si32(sum);
+}
+
+#endif
+
+// @brief: picks the fastest kernels the processor runs.
+static void selectKernels(void) {
+    addColumn = addColumnScalar;
+    subtractColumn = subtractColumnScalar;
+    dotProduct = dotProductScalar;
+    kernelName = "scalar";
+#if NNUE_X86
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2")) {
+        addColumn = addColumnAvx2;
+        subtractColumn = subtractColumnAvx2;
+        dotProduct = dotProductAvx2;
+        kernelName = "avx2";
+    } else if (__builtin_cpu_supports("sse4.1")) {
+        addColumn = addColumnSse41;
+        subtractColumn = subtractColumnSse41;
+        dotProduct = dotProductSse41;
+        kernelName = "sse4.1";
+    }
+#endif
+}
+
+// @brief: reads count little-endian 32-bit integers; returns 1 if all were there.
+static int readIntegers(FILE *file, int *values, int count) {
+    unsigned char bytes[4];
+    for (int i = 0; i < count; i++) {
+        if (fread(bytes, 1, 4, file) != 4) return 0;
+        values[i] = (int)((unsigned int)bytes[0] | (unsigned int)bytes[1] << 8 |
+                          (unsigned int)bytes[2] << 16 | (unsigned int)bytes[3] << 24);
+    }
+    return 1;
+}
+
+// @brief: reads count little-endian 16-bit integers; returns 1 if all were there.
+static int readShorts(FILE *file, short int *values, int count) {
+    unsigned char bytes[2];
+    for (int i = 0; i < count; i++) {
+        if (fread(bytes, 1, 2, file) != 2) return 0;
+        values[i] = (short int)(unsigned short int)(bytes[0] | bytes[1] << 8);
+    }
+    return 1;
+}
+
+int nnueLoad(const char *path) {
+    loaded = 0;
+    nnueInUse = 0;
+    FILE *file = fopen(path, "rb");
+    if (!file) return ERROR_CODE;
+
+    char magic[4];
+    int header[3]; // version, hidden neurons, output scale
+    int valid = fread(magic, 1, 4, file) == 4 && memcmp(magic, NNUE_MAGIC, 4) == 0 &&
+                readIntegers(file, header, 3) && header[0] == NNUE_VERSION && header[1] == NNUE_HIDDEN &&
+                header[2] > 0 &&
+                readShorts(file, &featureWeights[0][0], NNUE_FEATURES * NNUE_HIDDEN) &&
+                readShorts(file, featureBiases, NNUE_HIDDEN) &&
+                fread(outputWeights, 1, sizeof(outputWeights), file) == sizeof(outputWeights) &&
+                readIntegers(file, &outputBias, 1);
+    fclose(file);
+    if (!valid) return ERROR_CODE;
+
+    outputScale = header[2];
+    selectKernels();
+    loaded = 1;
+    return 0;
+}
+
+int nnueLoaded(void) {
+    return loaded;
+}
+
+int nnueUse(int enabled) {
+    nnueInUse = enabled && loaded;
+    return nnueInUse;
+}
+
+const char *nnueKernel(void) {
+    return kernelName;
+}
+
+// @brief: the feature of a piece on a square, seen from one color's side.
+static int featureIndex(int perspective, int piece, int square) {
+    if (perspective == WHITE) return piece * 64 + square;
+    return ((piece + 6) % 12) * 64 + (square ^ 56);
+}
+
+void nnueRefresh(Board board) {
+    if (!loaded) return;
+    for (int perspective = WHITE; perspective <= BLACK; perspective++) {
+        memcpy(board->accumulator[perspective], featureBiases, sizeof(featureBiases));
+    }
+    for (int piece = 0; piece < 12; piece++) {
+        unsigned long long pieces = board->bitboards[piece];
+        while (pieces) {
+            nnueAddPiece(board, piece, __builtin_ctzll(pieces));
+            pieces &= pieces - 1;
+        }
+    }
+}
+
+void nnueAddPiece(Board board, int piece, int square) {
+    addColumn(board->accumulator[WHITE], featureWeights[featureIndex(WHITE, piece, square)]);
+    addColumn(board->accumulator[BLACK], featureWeights[featureIndex(BLACK, piece, square)]);
+}
+
+void nnueRemovePiece(Board board, int piece, int square) {
+    subtractColumn(board->accumulator[WHITE], featureWeights[featureIndex(WHITE, piece, square)]);
+    subtractColumn(board->accumulator[BLACK], featureWeights[featureIndex(BLACK, piece, square)]);
+}
+
+int nnueEvaluate(Board board) {
+    int us = (board->toMove == 'w') ? WHITE : BLACK;
+    long long output = (long long)dotProduct(board->accumulator[us], outputWeights[0]) +
+                       dotProduct(board->accumulator[!us], outputWeights[1]) + outputBias;
+    // From centipawns to engine units, in one division so that no precision is lost on the way.
+    long long score = output * outputScale * P_VALUE / (NNUE_ACTIVATION_MAX * NNUE_WEIGHT_SCALE * NNUE_CENTIPAWNS);
+    if (score > NNUE_SCORE_LIMIT) score = NNUE_SCORE_LIMIT;
+    if (score < -NNUE_SCORE_LIMIT) score = -NNUE_SCORE_LIMIT;
+    return (int)score;
+}
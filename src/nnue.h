@@ -0,0 +1,57 @@
+#ifndef NNUE
+#define NNUE
+
+#include "init.h"
+
+/*
+Network file, all numbers little-endian:
+- "FONN", then the version, NNUE_HIDDEN and the output scale (32-bit integers)
+- feature weights (16-bit, NNUE_FEATURES rows of NNUE_HIDDEN) and feature biases (16-bit, NNUE_HIDDEN)
+- output weights (8-bit, NNUE_HIDDEN for the side to move, then NNUE_HIDDEN for the other side)
+- output bias (32-bit)
+Feature piece * 64 + square is a piece on a square (bitboard order, a8 = 0) seen from white's side;
+from black's side colors are swapped and ranks flipped.
+*/
+#define NNUE_MAGIC "FONN"
+#define NNUE_VERSION 1
+#define NNUE_FEATURES 768
+
+// First-layer outputs are clipped to [0, NNUE_ACTIVATION_MAX], and the output weights are stored
+// multiplied by NNUE_WEIGHT_SCALE; the output, times the file's scale (which must be positive),
+// divided by both, is the score in centipawns, as trainers write it. The search's margins are in
+// the units of the classical evaluation, P_VALUE to a pawn, so the score is converted to those.
+#define NNUE_ACTIVATION_MAX 127
+#define NNUE_WEIGHT_SCALE 64
+#define NNUE_CENTIPAWNS 100 // a pawn, in the network's units
+
+// Network the command line (choose_move) and the batch mode use when this file exists in the
+// working directory; UCI loads one only through the EvalFile option
+#define NNUE_DEFAULT_FILE "engine.nnue"
+
+// Scores of the network are kept within this (in engine units), clear of the mate scores
+#define NNUE_SCORE_LIMIT 10000
+
+// Whether evaluateBitboard uses the network, and makeMove keeps the accumulators for it
+extern int nnueInUse;
+
+// Reads a network file; returns 0 if successful, ERROR_CODE otherwise (the previous network is lost)
+int nnueLoad(const char *path);
+int nnueLoaded(void);
+
+// Switches between the network and the classical evaluation; returns whether the network is in use
+int nnueUse(int enabled);
+
+// Instruction set the inference runs with: "avx2", "sse4.1" or "scalar"
+const char *nnueKernel(void);
+
+// Computes the accumulators of a position from scratch
+void nnueRefresh(Board board);
+
+// Updates the accumulators for a piece placed on or taken off a square
+void nnueAddPiece(Board board, int piece, int square);
+void nnueRemovePiece(Board board, int piece, int square);
+
+// Evaluates a position from the point of view of the player to move
+int nnueEvaluate(Board board);
+
+#endif
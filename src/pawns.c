@@ -0,0 +1,88 @@
+/**
+ * @file pawns.c
+ * @brief This file contains the pawn-structure evaluation and the pawn hash table that caches
+ * it. Pawns move rarely, so nearly every position the search evaluates has the pawns of a
+ * position evaluated shortly before: the table, indexed by the pawn key (board->pawnKey),
+ * hands back their score without looking at the pawns again.
+ */
+
+#include <string.h>
+
+#include "init.h"
+#include "pawns.h"
+#include "attacks.h"
+
+// Every search thread has its own table, so no entry is ever read while another thread writes it.
+static _Thread_local PawnEntry pawnTable[PAWN_TABLE_SIZE];
+
+static const int passedMg[8] = PASSED_PAWN_MG;
+static const int passedEg[8] = PASSED_PAWN_EG;
+
+// @brief: the squares of a set and every square below them (towards rank 1).
+static unsigned long long southFill(unsigned long long set) {
+    set |= set << 8;
+    set |= set << 16;
+    return set | (set << 32);
+}
+
+// @brief: the squares of a set and every square above them (towards rank 8).
+static unsigned long long northFill(unsigned long long set) {
+    set |= set >> 8;
+    set |= set >> 16;
+    return set | (set >> 32);
+}
+
+// @brief: a set together with the squares next to it on the adjacent files.
+static unsigned long long widen(unsigned long long set) {
+    return set | ((set << 1) & ~FILE_A) | ((set >> 1) & ~FILE_H);
+}
+
+/*
+@brief: evaluates the pawns of one color into an entry, with the sign of the color. All the
+pawns are classified at once by shifting whole bitboards; only passed pawns, whose bonus depends
+on their rank, are visited one by one.
+- supported (guarding another pawn of the color): a pawn of the color stands where it captures
+- backward: no pawn of the color on the row behind it, on its file or the adjacent ones
+- passed: no enemy pawn in front of it on its file or the adjacent ones
+*/
+static void evaluatePawns(PawnEntry *entry, unsigned long long pawns, unsigned long long enemies, int color) {
+    int sign = (color == WHITE) ? 1 : -1;
+    unsigned long long guarding, backward, stopped;
+
+    if (color == WHITE) {
+        guarding = pawns & (((pawns << 9) & ~FILE_A) | ((pawns << 7) & ~FILE_H));
+        backward = pawns & ~(widen(pawns) >> 8);
+        stopped = widen(southFill(enemies << 8)); // enemy pawns stop a pawn from their square on
+    } else {
+        guarding = pawns & (((pawns >> 7) & ~FILE_A) | ((pawns >> 9) & ~FILE_H));
+        backward = pawns & ~(widen(pawns) << 8);
+        stopped = widen(northFill(enemies >> 8));
+    }
+    unsigned long long passed = pawns & ~stopped;
+
+    // These terms count the same in the middlegame and the endgame.
+    int structure = SUPPORTED_PAWN_BONUS * __builtin_popcountll(guarding)
+                  - BACKWARD_PAWN_PENALTY * __builtin_popcountll(backward);
+    entry->mg += sign * structure;
+    entry->eg += sign * structure;
+
+    while (passed) {
+        int square = __builtin_ctzll(passed);
+        int rank = (color == WHITE) ? RANK_OF(square) : 7 - RANK_OF(square);
+        entry->mg += sign * passedMg[rank];
+        entry->eg += sign * passedEg[rank];
+        passed &= passed - 1;
+    }
+}
+
+const PawnEntry *probePawns(Board board) {
+    // An empty entry has key 0, which is right for a board without pawns: nothing to score.
+    PawnEntry *entry = &pawnTable[board->pawnKey & (PAWN_TABLE_SIZE - 1)];
+    if (entry->key == board->pawnKey) return entry;
+
+    memset(entry, 0, sizeof(PawnEntry));
+    entry->key = board->pawnKey;
+    evaluatePawns(entry, board->bitboards[WHITE_PAWNS], board->bitboards[BLACK_PAWNS], WHITE);
+    evaluatePawns(entry, board->bitboards[BLACK_PAWNS], board->bitboards[WHITE_PAWNS], BLACK);
+    return entry;
+}
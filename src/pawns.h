@@ -0,0 +1,26 @@
+#ifndef PAWNS
+#define PAWNS
+
+#include "init.h"
+
+// Entries of the pawn hash table of every search thread (a power of two)
+#define PAWN_TABLE_SIZE 8192
+
+// Pawn-structure terms
+#define BACKWARD_PAWN_PENALTY 10
+#define SUPPORTED_PAWN_BONUS 15
+
+// Bonus of a passed pawn by its rank, counted from its own side (middlegame, endgame)
+#define PASSED_PAWN_MG {0, 5, 5, 10, 15, 25, 40, 0}
+#define PASSED_PAWN_EG {0, 10, 10, 20, 30, 50, 75, 0}
+
+// What the pawns of a position are worth
+typedef struct pawnEntry {
+    unsigned long long key; // pawn key of the structure (board->pawnKey)
+    int mg, eg; // pawn-structure score, white minus black (middlegame, endgame)
+} PawnEntry;
+
+// Returns the pawn structure of a board, evaluated only if the thread's table misses it
+const PawnEntry *probePawns(Board board);
+
+#endif
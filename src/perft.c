@@ -0,0 +1,117 @@
+/**
+ * @file perft.c
+ * @brief This file contains the perft (performance test) functions, which walk the legal
+ * move tree to a fixed depth to check the move generator against known node counts and
+ * to measure its speed.
+ */
+
+#include <stdio.h>
+#include <string.h>
+
+#include "init.h"
+#include "perft.h"
+#include "bitboard.h"
+#include "capture.h"
+#include "tools.h"
+
+// A position of the suite and its known node count at some depth
+typedef struct perftCase {
+    const char *fen;
+    int depth;
+    unsigned long long nodes;
+} PerftCase;
+
+// The usual perft positions (start position, "Kiwipete", positions 3 to 6 of the
+// chessprogramming wiki), followed by small endgames aimed at castling, en passant
+// and promotion corner cases.
+static const PerftCase SUITE[] = {
+    {"rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1", 5, 4865609ULL},
+    {"r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1", 4, 4085603ULL},
+    {"8/2p5/3p4/KP5r/1R3p1k/8/4P1P1/8 w - - 0 1", 5, 674624ULL},
+    {"r3k2r/Pppp1ppp/1b3nbN/nP6/BBP1P3/q4N2/Pp1P2PP/R2Q1RK1 w kq - 0 1", 4, 422333ULL},
+    {"rnbq1k1r/pp1Pbppp/2p5/8/2B5/8/PPP1NnPP/RNBQK2R w KQ - 1 8", 4, 2103487ULL},
+    {"r4rk1/1pp1qppp/p1np1n2/2b1p1B1/2B1P1b1/P1NP1N2/1PP1QPPP/R4RK1 w - - 0 10", 4, 3894594ULL},
+    {"3k4/3p4/8/K1P4r/8/8/8/8 b - - 0 1", 6, 1134888ULL},
+    {"8/8/4k3/8/2p5/8/B2P2K1/8 w - - 0 1", 6, 1015133ULL},
+    {"8/8/1k6/2b5/2pP4/8/5K2/8 b - d3 0 1", 6, 1440467ULL},
+    {"5k2/8/8/8/8/8/8/4K2R w K - 0 1", 6, 661072ULL},
+    {"r3k2r/1b4bq/8/8/8/8/7B/R3K2R w KQkq - 0 1", 4, 1274206ULL},
+    {"8/8/2k5/5q2/5n2/8/5K2/8 b - - 0 1", 4, 23527ULL},
+    {"2K2r2/4P3/8/8/8/8/8/3k4 w - - 0 1", 6, 3821001ULL},
+    {"8/P1k5/K7/8/8/8/8/8 w - - 0 1", 6, 92683ULL},
+    {"8/k1P5/8/1K6/8/8/8/8 w - - 0 1", 7, 567584ULL},
+};
+
+// @brief: nodes per second, guarding against runs too short to measure.
+static unsigned long long nodesPerSecond(unsigned long long nodes, long long elapsed) {
+    return elapsed > 0 ? nodes * 1000ULL / (unsigned long long)elapsed : 0ULL;
+}
+
+unsigned long long perft(Board board, int depth) {
+    MoveList moves;
+    generateLegalMoves(board, &moves);
+
+    // The generator only emits legal moves, so the last ply needs no make/unmake.
+    if (depth <= 1) return depth == 1 ? (unsigned long long)moves.count : 1ULL;
+
+    unsigned long long nodes = 0;
+    for (int i = 0; i < moves.count; i++) {
+        makeMove(board, moves.moves[i]);
+        nodes += perft(board, depth - 1);
+        unmakeMove(board);
+    }
+    return nodes;
+}
+
+unsigned long long perftDivide(Board board, int depth) {
+    MoveList moves;
+    char buffer[6];
+    unsigned long long total = 0;
+    long long start = timeMilliseconds();
+
+    generateLegalMoves(board, &moves);
+    for (int i = 0; i < moves.count; i++) {
+        makeMove(board, moves.moves[i]);
+        unsigned long long nodes = (depth > 1) ? perft(board, depth - 1) : 1ULL;
+        unmakeMove(board);
+
+        moveToUci(moves.moves[i], buffer);
+        printf("%s: %llu\n", buffer, nodes);
+        total += nodes;
+    }
+
+    long long elapsed = timeMilliseconds() - start;
+    printf("\nNodes: %llu\nTime: %lld ms\nNPS: %llu\n", total, elapsed, nodesPerSecond(total, elapsed));
+    return total;
+}
+
+int perftSuite(void) {
+    int count = sizeof(SUITE) / sizeof(SUITE[0]), failures = 0;
+    unsigned long long totalNodes = 0;
+    long long totalTime = 0;
+    struct board board;
+
+    for (int i = 0; i < count; i++) {
+        memset(&board, 0, sizeof(board));
+        if (parseFenRec(&board, (char *)SUITE[i].fen) != 0) {
+            printf("#%-2d FEN parsing failed: %s\n", i + 1, SUITE[i].fen);
+            failures++;
+            continue;
+        }
+
+        long long start = timeMilliseconds();
+        unsigned long long nodes = perft(&board, SUITE[i].depth);
+        long long elapsed = timeMilliseconds() - start;
+        totalNodes += nodes;
+        totalTime += elapsed;
+
+        int ok = (nodes == SUITE[i].nodes);
+        if (!ok) failures++;
+        printf("#%-2d %s depth %d: %llu nodes (expected %llu), %lld ms\n", i + 1, ok ? "ok  " : "FAIL",
+               SUITE[i].depth, nodes, SUITE[i].nodes, elapsed);
+    }
+
+    printf("\n%d/%d passed, %llu nodes in %lld ms (%llu nodes/s)\n", count - failures, count, totalNodes,
+           totalTime, nodesPerSecond(totalNodes, totalTime));
+    return failures;
+}
@@ -0,0 +1,15 @@
+#ifndef PERFT
+#define PERFT
+
+#include "init.h"
+
+// Counts the leaf nodes of the legal move tree to the given depth
+unsigned long long perft(Board board, int depth);
+
+// Prints the node count below every root move, the total and the speed
+unsigned long long perftDivide(Board board, int depth);
+
+// Runs the standard positions against their known counts, returns the number of failures
+int perftSuite(void);
+
+#endif
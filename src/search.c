@@ -1,6 +1,7 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <stdatomic.h>
 #include <math.h>
 //#include <emscripten.h>
 
@@ -9,146 +10,645 @@
 #include "evaluate.h"
 #include "init.h"
 #include "movegen.h"
+#include "capture.h"
 #include "tools.h"
+#include "transposition.h"
+#include "movepick.h"
+#include "threads.h"
+#include "timeman.h"
+#include "nnue.h"
 
-void clearEnPassant(Board board) {
-    board->pass[0] = '-';
-    board->pass[1] = '\0';
+// The running search, shared by all threads (set by iterativeDeepening)
+static const Move *rootMoves;
+static int rootCount;
+static const SearchLimits *limits;
+static int maxDepth;
+static TimeManager timeManager;
+static atomic_int stopped; // set once the search is over; every score after that is meaningless
+
+// @brief: tells whether the search is over, without counting a node.
+static int isStopped(void) {
+    return atomic_load_explicit(&stopped, memory_order_relaxed);
 }
 
-int enemyPiece(Board board, int square) {
-    int start = (board->toMove == 'w') ? 6 : 0;
-    int end = start + 6;
-    
-    for (int i = start; i < end; i++) {
-        if (IS_BIT_SET(board->bitboards[i], square)) {
-            return 1;
-        }
+/*
+@brief: counts a node and, every NODES_PER_CLOCK_CHECK nodes, checks the clock and whether
+another thread asked the search to stop.
+*/
+static int searchStopped(SearchThread *thread) {
+    if (isStopped()) return 1;
+    // Only this thread writes its count, so a plain increment is enough.
+    unsigned long long nodes = atomic_load_explicit(&thread->nodes, memory_order_relaxed) + 1;
+    atomic_store_explicit(&thread->nodes, nodes, memory_order_relaxed);
+    if (nodes % NODES_PER_CLOCK_CHECK == 0 &&
+        (timeOut(&timeManager) || (limits->stop && atomic_load(limits->stop)))) {
+        atomic_store_explicit(&stopped, 1, memory_order_relaxed);
+        return 1;
     }
     return 0;
 }
 
-// Quiescence search function
-double quiescence(Board board, double alpha, double beta) {
+// @brief: fills result with what a thread found and the work of all threads so far.
+static void fillResult(const SearchThread *thread, SearchResult *result) {
+    result->best = thread->best;
+    result->score = thread->bestScore;
+    result->depth = thread->completedDepth;
+    result->nodes = 0;
+    for (int id = 0; id < threadCount(); id++) {
+        result->nodes += atomic_load_explicit(&getThread(id)->nodes, memory_order_relaxed);
+    }
+    result->time = timeElapsed(&timeManager);
+}
+
+/*
+@brief: called by the main thread after each iteration it completed: reports it, and tells
+whether to stop there (forced mate found, or the time manager wants no new iteration).
+*/
+static int finishIteration(SearchThread *thread) {
+    if (limits->report) {
+        SearchResult result;
+        fillResult(thread, &result);
+        limits->report(&result);
+    }
+    if (limits->infinite) return 0;
+    if (timeStopIteration(&timeManager, thread->best)) return 1;
+    return thread->bestScore >= MATE_IN_MAX || thread->bestScore <= -MATE_IN_MAX;
+}
+
+// Material a capture wins at most, by type of the piece taken (WHITE_PAWNS ... WHITE_KING)
+static const int DELTA_VALUES[6] = {P_VALUE, R_VALUE, N_VALUE, B_VALUE, Q_VALUE, 0};
+
+// Quiescence search function (fail-soft, scores relative to the player to move)
+int quiescence(SearchThread *thread, int alpha, int beta) {
+    Board board = &thread->board;
+    if (searchStopped(thread)) return 0;
+
     // Evaluate the current position
-    double stand_pat = evaluateBitboard(board);
+    int stand_pat = evaluateBitboard(board);
 
     // Fail-high beta cutoff
     if (stand_pat >= beta) {
-        return beta;
+        return stand_pat;
     }
 
     // Update alpha if stand_pat is better
+    int bestScore = stand_pat;
     if (stand_pat > alpha) {
         alpha = stand_pat;
     }
 
-    // Generate capture moves only
-    int moveCount;
-    char *legalCaptures = generateLegalCaptures(board);
-    if (legalCaptures == NULL) return alpha; // Return alpha instead of 0
+    // Generate capture moves only (including en passant), most valuable victims first
+    MovePicker picker;
+    initCapturePicker(&picker, board);
 
-    char **moves = initMoveSave(legalCaptures, &moveCount);
-    free(legalCaptures); // Free the string containing moves
-    if (moves == NULL) return alpha;
+    Move move;
+    while ((move = nextMove(&picker)) != NO_MOVE) {
+        // Captures that lose material (by static exchange evaluation) and underpromotions come
+        // last and are not worth searching at all.
+        if (pickedLosing(&picker)) break;
 
-    for (int i = 0; i < moveCount; i++) {
-        short int dst = (moves[i][3] - '1') * 8 + (moves[i][2] - 'a');
-
-        // Check if move is a valid capture (including en passant)
-        if (enemyPiece(board, dst)) {
-            // Create new board state
-            Board newBoard = malloc(sizeof(struct board));
-            if (!newBoard) {
-                freeMoveSave(moves, moveCount);
-                return alpha;
+        // Delta pruning: a capture that cannot bring the score up to alpha even with DELTA_MARGIN
+        // on top of the material it takes is skipped. Promotions, and pawns capturing onto the
+        // rank before promotion (which the evaluation rewards with its largest passed-pawn
+        // bonus), get DELTA_PROMOTION more. Off while the neural evaluation is in use.
+        if (!nnueInUse) {
+            int optimistic = stand_pat + DELTA_VALUES[MOVE_CAPTURED(move) % 6] + DELTA_MARGIN;
+            int to = MOVE_TO(move);
+            if (MOVE_PROMOTION(move) || (MOVE_PIECE(move) % 6 == WHITE_PAWNS && (RANK_OF(to) == 1 || RANK_OF(to) == 6))) {
+                optimistic += DELTA_PROMOTION;
+            }
+            if (optimistic <= alpha) {
+                if (optimistic > bestScore) bestScore = optimistic;
+                thread->deltaPrunes++;
+                continue;
             }
+        }
 
-            memcpy(newBoard, board, sizeof(struct board));
-            UpdateBitboards(newBoard, moves[i]);
+        // Recursive quiescence search on the position after the capture
+        makeMove(board, move);
+        int eval = -quiescence(thread, -beta, -alpha);
+        unmakeMove(board);
 
-            // Recursive quiescence search
-            double eval = -quiescence(newBoard, -beta, -alpha);
-            free(newBoard); // Free allocated board
+        if (eval > bestScore) bestScore = eval;
+        if (eval >= beta) break; // beta cutoff
 
-            // Fail-hard beta cutoff
-            if (eval >= beta) {
-                freeMoveSave(moves, moveCount);
-                return beta;
-            }
+        if (eval > alpha) {
+            alpha = eval;
+        }
+    }
 
-            if (eval > alpha) {
-                alpha = eval;
-            }
+    return bestScore;
+}
+
+/*
+Mate scores count the plies from the root (the sooner the mate, the larger the score), but a
+table entry may be reached at another distance from the root: the table stores them counted
+from the position itself instead.
+*/
+static int toTable(int score, int ply) {
+    if (score >= MATE_IN_MAX) return score + ply;
+    if (score <= -MATE_IN_MAX) return score - ply;
+    return score;
+}
+
+static int fromTable(int score, int ply) {
+    if (score >= MATE_IN_MAX) return score - ply;
+    if (score <= -MATE_IN_MAX) return score + ply;
+    return score;
+}
+
+// Depth reductions of late moves, by [depth][move number] (filled by initReductions)
+static int reductions[MAX_DEPTH + 1][MAX_MOVES];
+
+// @brief: fills the reductions table: they grow with the logarithms of depth and move number.
+static void initReductions(void) {
+    if (reductions[MAX_DEPTH][MAX_MOVES - 1]) return;
+    for (int depth = 1; depth <= MAX_DEPTH; depth++) {
+        for (int count = 1; count < MAX_MOVES; count++) {
+            reductions[depth][count] = (int)(0.75 + log(depth) * log(count) / 2.25);
         }
     }
+}
+
+static int lateMoveReduction(int depth, int moveCount) {
+    return reductions[depth < MAX_DEPTH ? depth : MAX_DEPTH][moveCount < MAX_MOVES ? moveCount : MAX_MOVES - 1];
+}
 
-    freeMoveSave(moves, moveCount);
-    return alpha;
+// @brief: tells whether the player to move has a piece other than pawns and the king.
+static int hasNonPawnMaterial(Board board) {
+    int base = (board->toMove == 'w') ? WHITE_PAWNS : BLACK_PAWNS;
+    return (board->bitboards[base + WHITE_ROOKS] | board->bitboards[base + WHITE_KNIGHTS] |
+            board->bitboards[base + WHITE_BISHOPS] | board->bitboards[base + WHITE_QUEEN]) != 0;
 }
 
+/*
+@brief: negamax alpha-beta search with transposition table and quiescence search at the leaves.
+Fail-soft: the score returned may lie outside the (alpha, beta) window, as a bound.
+
+return: the score of the position for the player to move; ply is the distance from the root.
+*/
+int negamax(SearchThread *thread, int depth, int alpha, int beta, int ply) {
+    Board board = &thread->board;
+    if (searchStopped(thread)) return 0;
 
-// Minimax function with alpha-beta pruning and quiescence search
-double minimax(Board board, int depth, double alpha, double beta, bool maximizingPlayer) {
+    // No mate found from here can beat a mate already found closer to the root.
+    if (alpha < -MATE_SCORE + ply) alpha = -MATE_SCORE + ply;
+    if (beta > MATE_SCORE - ply - 1) beta = MATE_SCORE - ply - 1;
+    if (alpha >= beta) return alpha;
 
-    if(!board) return 0;
+    // At the leaves only the end of the game is settled here (checkmate is lost for the player
+    // to move, stalemate is a draw); the quiescence search does the rest.
+    if (depth == 0) {
+        if (!hasLegalMove(board)) return isKingAttacked(board) ? -MATE_SCORE + ply : 0;
+        return quiescence(thread, alpha, beta);
+    }
+
+    // An earlier search of this position, deep enough, may settle it or narrow the window.
+    TTEntry entry;
+    Move hashMove = NO_MOVE;
+    if (ttProbe(board->key, &entry)) {
+        hashMove = entry.move;
+        if (entry.depth >= depth) {
+            int score = fromTable(entry.score, ply);
+            int bound = TT_BOUND(&entry);
+            if (bound == TT_EXACT) return score;
+            if (bound == TT_LOWER && score >= beta) return score;
+            if (bound == TT_UPPER && score <= alpha) return score;
+        }
+    }
 
-    char currentPlayer = board->toMove;
     int inCheck = isKingAttacked(board);
+    int pvNode = (beta - alpha > 1);
+
+    // Null-move pruning: if passing the turn still leaves the player to move at or above beta
+    // after a reduced search, a real move would too. Not in check, not twice in a row, and only
+    // with pieces left, since in pawn endings passing may be the only good "move" (zugzwang).
+    if (!pvNode && !inCheck && depth >= NULL_MOVE_DEPTH && beta < MATE_IN_MAX && hasNonPawnMaterial(board) &&
+        !(board->ply > 0 && board->history[board->ply - 1].move == NO_MOVE) && evaluateBitboard(board) >= beta) {
+        int reduction = 3 + depth / 6;
+        makeNullMove(board);
+        int eval = -negamax(thread, depth - 1 - reduction > 0 ? depth - 1 - reduction : 0, -beta, -beta + 1, ply + 1);
+        unmakeNullMove(board);
+        if (isStopped()) return 0;
+        if (eval >= beta) return eval >= MATE_IN_MAX ? beta : eval; // unproven mates are not trusted
+    }
+
+    // Generate all legal moves, to be handed out best first
+    MovePicker picker;
+    initMovePicker(&picker, board, hashMove, &thread->heuristics, ply);
+
+    if (picker.list.count == 0) {
+        // Checkmate is lost for the player to move, stalemate is a draw
+        return inCheck ? -MATE_SCORE + ply : 0;
+    }
+
+    int alphaOrigin = alpha;
+    int bestScore = -INFINITE_SCORE;
+    Move bestMove = NO_MOVE;
+    Move move;
     int moveCount = 0;
 
-    // Generate all legal moves
-    char *legalMoves = generateLegalMoves(board);
-    if(legalMoves == NULL) return 0;
-    char **moves = initMoveSave(legalMoves, &moveCount);
-    free(legalMoves);
-    if(!moves) return 0;
+    while ((move = nextMove(&picker)) != NO_MOVE) {
+        int quiet = (MOVE_CAPTURED(move) == NO_PIECE && !MOVE_PROMOTION(move));
+        moveCount++;
+
+        // Apply a move (this also switches the player to move) and take it back afterwards
+        makeMove(board, move);
+        int eval;
+        if (bestMove == NO_MOVE) {
+            eval = -negamax(thread, depth - 1, -beta, -alpha, ply + 1);
+        } else {
+            // Late move reductions: quiet moves ordered late rarely turn out best, so they are
+            // searched less deep first (less so if their history is good) and only searched
+            // to full depth if they beat alpha anyway.
+            int reduction = 0;
+            if (depth >= LMR_DEPTH && moveCount > LMR_MOVES && quiet && !inCheck && !isKingAttacked(board) &&
+                move != thread->heuristics.killers[ply][0] && move != thread->heuristics.killers[ply][1]) {
+                reduction = lateMoveReduction(depth, moveCount);
+                reduction -= thread->heuristics.history[MOVE_PIECE(move)][MOVE_TO(move)] / (HISTORY_MAX / 2);
+                if (pvNode) reduction--;
+                if (reduction > depth - 2) reduction = depth - 2;
+                if (reduction < 0) reduction = 0;
+            }
+
+            // Principal variation search: the first move is likely the best, so the others only
+            // have to prove they are not better (null window), and are searched again if they are.
+            eval = -negamax(thread, depth - 1 - reduction, -alpha - 1, -alpha, ply + 1);
+            if (eval > alpha && reduction > 0) eval = -negamax(thread, depth - 1, -alpha - 1, -alpha, ply + 1);
+            if (eval > alpha && eval < beta) eval = -negamax(thread, depth - 1, -beta, -alpha, ply + 1);
+        }
+        unmakeMove(board);
 
-    if (moveCount == 0) {
-        freeMoveSave(moves, moveCount); // Ensure moves is freed
-        return inCheck ? ((currentPlayer == 'w') ? -1e9 : 1e9) : 0;
+        if (eval > bestScore) {
+            bestScore = eval;
+            bestMove = move;
+        }
+        if (eval > alpha) alpha = eval;
+        if (alpha >= beta) {
+            // Prune the search tree, and remember the quiet move that did it.
+            if (quiet && !isStopped()) {
+                updateQuietHeuristics(&thread->heuristics, move, picker.list.moves, picker.next - 1, depth, ply);
+            }
+            break;
+        }
     }
 
-    if (depth == 0) {
-        freeMoveSave(moves, moveCount); // Ensure moves is freed
-        //return evaluateBitboard(board);
-        return quiescence(board, alpha, beta);
-    }
-
-    double bestEval = maximizingPlayer ? -1e9 : 1e9;
-
-    for (int i = 0; i < moveCount; i++) {
-        Board newBoard = malloc(sizeof(struct board));
-        if (!newBoard) {
-            debugPrint("Memory allocation failed\n");
-            freeMoveSave(moves, moveCount); // Ensure moves is freed
-            return 0;
-        }
-
-        //  Initialisize bit board.
-        memset(newBoard, 0, sizeof(struct board));
-        memcpy(newBoard, board, sizeof(struct board)); // Copy the current board state
-        
-        // Apply a move
-        UpdateBitboards(newBoard, moves[i]);
-        newBoard->toMove = (newBoard->toMove == 'w') ? 'b' : 'w'; // Switch player
-        debugPrint("tomoce: %c\n", newBoard->toMove);
-        
-        double eval = minimax(newBoard, depth - 1, alpha, beta, !maximizingPlayer);
-        free(newBoard); // Free the allocated board
-
-        if (maximizingPlayer) {
-            bestEval = fmax(bestEval, eval);
-            alpha = fmax(alpha, eval);
+    // Results of an interrupted search are incomplete and must not be stored.
+    if (!isStopped()) {
+        int bound = (bestScore <= alphaOrigin) ? TT_UPPER : (bestScore >= beta) ? TT_LOWER : TT_EXACT;
+        ttStore(board->key, bestMove, toTable(bestScore, ply), depth, bound);
+    }
+
+    return bestScore;
+}
+
+// @brief: moves a root move index to the front of the search order.
+static void moveToFront(int *order, int index) {
+    for (int i = 0; i < rootCount; i++) {
+        if (order[i] == index) {
+            order[i] = order[0];
+            order[0] = index;
+            break;
+        }
+    }
+}
+
+/*
+@brief: searches the root moves in the given order within the window (alpha, beta), the first
+one with the window and the others (principal variation search) with a null window first.
+
+return: the best score found (fail-soft); best receives the index in the root moves of the move
+that raised alpha last, or -1 if none did (the search failed low or was stopped before).
+*/
+static int searchRootWindow(SearchThread *thread, int depth, const int *order, int alpha, int beta, int *best) {
+    Board board = &thread->board;
+    int bestScore = -INFINITE_SCORE;
+    *best = -1;
+
+    for (int i = 0; i < rootCount; i++) {
+        makeMove(board, rootMoves[order[i]]);
+        int score;
+        if (i == 0) {
+            score = -negamax(thread, depth - 1, -beta, -alpha, 1);
         } else {
-            bestEval = fmin(bestEval, eval);
-            beta = fmin(beta, eval);
+            score = -negamax(thread, depth - 1, -alpha - 1, -alpha, 1);
+            if (score > alpha && score < beta && !isStopped()) score = -negamax(thread, depth - 1, -beta, -alpha, 1);
         }
+        unmakeMove(board);
 
-        if (beta <= alpha) break; // Prune the search tree
+        if (isStopped()) break;
+        if (score > bestScore) bestScore = score;
+        if (score > alpha) {
+            alpha = score;
+            *best = order[i];
+        }
+        if (score >= beta) break;
     }
+    return bestScore;
+}
 
-    debugPrint("depth: %d, BestEval: %f\n", depth, bestEval);
-    freeMoveSave(moves, moveCount); // Ensure moves is freed
-    return bestEval;
-}
\ No newline at end of file
+/*
+@brief: one thread's iterative deepening over the root moves, one ply deeper per iteration,
+best move of the previous iteration first. From ASPIRATION_DEPTH on, an iteration first searches
+a narrow window around the previous score, widened and searched again whenever the score falls
+outside. An iteration the search's end interrupts only counts as far as it got: a move that
+finished with a better score than the previous best move's replaces it.
+
+The main thread decides when the search ends and then stops the helpers. Helpers (Lazy SMP)
+search the same root moves at staggered depths, odd ones a ply ahead, so that the threads
+spread over different subtrees and hand each other results through the transposition table.
+*/
+static void searchRoot(SearchThread *thread) {
+    int order[MAX_MOVES]; // root move indices, best move of the last iteration first
+    for (int i = 0; i < rootCount; i++) order[i] = i;
+    thread->best = 0;
+    thread->bestScore = 0;
+    thread->completedDepth = 0;
+
+    for (int depth = 1 + (thread->id & 1); depth <= maxDepth; depth++) {
+        int alpha = -INFINITE_SCORE, beta = INFINITE_SCORE, delta = ASPIRATION_WINDOW;
+        if (depth >= ASPIRATION_DEPTH && thread->bestScore > -MATE_IN_MAX && thread->bestScore < MATE_IN_MAX) {
+            alpha = thread->bestScore - delta;
+            beta = thread->bestScore + delta;
+        }
+
+        while (1) {
+            int best, score = searchRootWindow(thread, depth, order, alpha, beta, &best);
+            if (best != -1) {
+                thread->best = best;
+                thread->bestScore = score;
+                moveToFront(order, best);
+            }
+            if (isStopped()) break;
+
+            // Widen the side the score fell out of, more every time.
+            if (score <= alpha) alpha = (score - delta > -INFINITE_SCORE) ? score - delta : -INFINITE_SCORE;
+            else if (score >= beta) beta = (score + delta < INFINITE_SCORE) ? score + delta : INFINITE_SCORE;
+            else break;
+            delta *= 2;
+        }
+
+        if (isStopped()) break;
+        thread->completedDepth = depth;
+        if (thread->id == 0) {
+            debugPrint("depth %d: best %d, score %d, %lld ms\n", depth, thread->best, thread->bestScore,
+                       timeElapsed(&timeManager));
+            if (finishIteration(thread)) break;
+        }
+    }
+
+    if (thread->id == 0) atomic_store_explicit(&stopped, 1, memory_order_relaxed);
+}
+
+// Root splitting: the state of the iteration all threads are working on together
+static int splitDepth;
+static int splitOrder[MAX_MOVES]; // root move indices, best move of the last iteration first
+static atomic_int nextRootMove; // position in splitOrder of the next move nobody took yet
+static atomic_llong splitBest; // best result of the iteration so far (see packRootResult), 0 if none
+
+// @brief: packs a root move result so that a better score compares higher; the low bits keep the
+// move's position in splitOrder.
+static long long packRootResult(int score, int position) {
+    return ((long long)(score + INFINITE_SCORE) << 16) | (MAX_MOVES - position);
+}
+
+static int rootResultScore(long long packed) {
+    return (int)(packed >> 16) - INFINITE_SCORE;
+}
+
+/*
+@brief: searches the root move at the given position of splitOrder with a thread, the best score
+any thread has found so far in this iteration serving as alpha, and records its result if it is
+exact and beats the best one. A null-window fail-low is only an upper bound, which may tie alpha,
+so it is never recorded.
+
+return: 1 if the move was searched to the end, 0 if the search was stopped meanwhile.
+*/
+static int searchRootMove(SearchThread *thread, int position) {
+    long long best = atomic_load(&splitBest);
+    int alpha = best ? rootResultScore(best) : -INFINITE_SCORE;
+
+    makeMove(&thread->board, rootMoves[splitOrder[position]]);
+    int score;
+    int exact = 0; // whether score is the move's score rather than a bound at or below alpha
+    if (alpha == -INFINITE_SCORE) {
+        score = -negamax(thread, splitDepth - 1, -INFINITE_SCORE, INFINITE_SCORE, 1);
+        exact = 1;
+    } else {
+        // Only a move that beats the best one so far needs its exact score.
+        score = -negamax(thread, splitDepth - 1, -alpha - 1, -alpha, 1);
+        if (score > alpha && !isStopped()) {
+            score = -negamax(thread, splitDepth - 1, -INFINITE_SCORE, -alpha, 1);
+            exact = score > alpha;
+        }
+    }
+    unmakeMove(&thread->board);
+    if (isStopped()) return 0;
+    if (!exact) return 1;
+
+    // Another thread may have recorded a better move meanwhile; on equal scores the first one stays.
+    long long packed = packRootResult(score, position);
+    while ((!best || score > rootResultScore(best)) && !atomic_compare_exchange_weak(&splitBest, &best, packed));
+    return 1;
+}
+
+// @brief: helper job of root splitting: takes the root moves nobody took yet, one at a time.
+static void splitRoot(SearchThread *thread) {
+    int position;
+    while ((position = atomic_fetch_add(&nextRootMove, 1)) < rootCount) {
+        if (!searchRootMove(thread, position)) break;
+    }
+}
+
+/*
+@brief: iterative deepening in which the threads share every iteration: the best move of the
+previous iteration is searched first, by the main thread alone, so that the score it sets
+bounds the other moves, which all threads then take from a common queue as they get free.
+An interrupted iteration counts if the first move was finished (the best move found then
+beat it or is it).
+
+return: the index in the root moves of the best move found.
+*/
+static int splitIterativeDeepening(SearchThread *thread) {
+    for (int i = 0; i < rootCount; i++) splitOrder[i] = i;
+    thread->best = 0;
+    thread->bestScore = 0;
+    thread->completedDepth = 0;
+
+    for (int depth = 1; depth <= maxDepth; depth++) {
+        splitDepth = depth;
+        atomic_store(&splitBest, 0);
+        atomic_store(&nextRootMove, 1);
+
+        if (searchRootMove(thread, 0)) {
+            startHelpers(splitRoot);
+            splitRoot(thread);
+            waitForHelpers();
+
+            long long best = atomic_load(&splitBest);
+            thread->best = splitOrder[MAX_MOVES - (best & 0xFFFF)];
+            thread->bestScore = rootResultScore(best);
+        }
+        if (isStopped()) break;
+        thread->completedDepth = depth;
+        debugPrint("depth %d: best %d, score %d, %lld ms (split)\n", depth, thread->best, thread->bestScore,
+                   timeElapsed(&timeManager));
+        if (finishIteration(thread)) break;
+
+        moveToFront(splitOrder, thread->best);
+    }
+
+    atomic_store(&stopped, 1);
+    return thread->best;
+}
+
+/*
+@brief: searches the root moves with every thread of the pool within the given limits. Short
+searches split the root moves between the threads, the others use Lazy SMP. If result is not
+NULL, it receives the score, depth and node count of the search as well.
+
+return: the index in moves of the best move found: with Lazy SMP the main thread's, unless a
+helper completed a deeper iteration.
+*/
+int iterativeDeepening(Board board, const Move *moves, int count, const SearchLimits *searchLimits,
+                       SearchResult *result) {
+    SearchResult unused;
+    if (!result) result = &unused;
+    memset(result, 0, sizeof(SearchResult));
+    if (count == 0) return 0;
+    if (!threadCount()) setThreadCount(DEFAULT_THREADS);
+    initReductions();
+
+    rootMoves = moves;
+    rootCount = count;
+    limits = searchLimits;
+    maxDepth = (limits->depth > 0 && limits->depth < MAX_DEPTH) ? limits->depth : MAX_DEPTH;
+    if (count == 1 && maxDepth > FORCED_MOVE_DEPTH) maxDepth = FORCED_MOVE_DEPTH;
+    initTimeManager(&timeManager, &limits->time);
+    atomic_store(&stopped, 0);
+
+    for (int id = 0; id < threadCount(); id++) {
+        SearchThread *thread = getThread(id);
+        memcpy(&thread->board, board, sizeof(struct board));
+        thread->nodes = 0;
+        thread->deltaPrunes = 0;
+        resetHeuristics(&thread->heuristics);
+    }
+
+    SearchThread *chosen = getThread(0);
+    if (threadCount() > 1 && timeManager.hard > 0 && timeManager.hard < ROOT_SPLIT_MS) {
+        splitIterativeDeepening(chosen);
+    } else {
+        startHelpers(searchRoot);
+        searchRoot(chosen);
+        waitForHelpers();
+        for (int id = 1; id < threadCount(); id++) {
+            if (getThread(id)->completedDepth > chosen->completedDepth) chosen = getThread(id);
+        }
+    }
+
+    fillResult(chosen, result);
+    debugPrint("%d threads, %llu nodes, thread %d chosen at depth %d\n", threadCount(), result->nodes, chosen->id,
+               chosen->completedDepth);
+    return chosen->best;
+}
+
+/*
+Positions in which a capture gains far more than the material it takes (it makes a passed pawn
+or puts a piece on a much better square), so that delta pruning with too small a margin skips
+the one move that beats alpha.
+*/
+static const char *QUIESCENCE_SUITE[] = {
+    "7k/3p4/4P3/8/8/8/8/K7 w - - 0 1",
+    "k7/8/8/8/8/4p3/3P4/7K b - - 0 1",
+};
+
+/*
+Positions with a quiet pawn capture and nothing else: searched with alpha a rook above the
+position's own score, delta pruning must skip the capture.
+*/
+static const char *DELTA_SUITE[] = {
+    "4k3/8/8/3p4/4P3/8/8/4K3 w - - 0 1",
+    "4k3/8/8/3p4/4P3/8/8/4K3 b - - 0 1",
+};
+
+/*
+Leaves whose only legal moves are captures (the last one en passant), and a checkmate and a
+stalemate: the end-of-game test at depth 0 must tell them apart.
+*/
+static const char *LEAF_SUITE[] = {
+    "k7/8/8/8/8/8/6qP/7K w - - 0 1",
+    "8/8/8/8/3pP3/1B1N4/2K5/k7 b - e3 0 1",
+    "R5k1/5ppp/8/8/8/8/8/6K1 b - - 0 1",
+    "7k/5Q2/6K1/8/8/8/8/8 b - - 0 1",
+};
+
+int quiescenceSuite(void) {
+    int count = sizeof(QUIESCENCE_SUITE) / sizeof(QUIESCENCE_SUITE[0]), failures = 0;
+    static SearchThread thread; // too big for the stack
+    static SearchLimits suiteLimits; // no limits
+    limits = &suiteLimits;
+    initTimeManager(&timeManager, &suiteLimits.time);
+    atomic_store(&stopped, 0);
+
+    for (int i = 0; i < count; i++) {
+        memset(&thread.board, 0, sizeof(thread.board));
+        if (parseFenRec(&thread.board, (char *)QUIESCENCE_SUITE[i]) != 0) {
+            printf("#%-2d FEN parsing failed: %s\n", i + 1, QUIESCENCE_SUITE[i]);
+            failures++;
+            continue;
+        }
+
+        // A window just below the exact score must fail high, or a capture was wrongly pruned.
+        int standPat = evaluateBitboard(&thread.board);
+        int score = quiescence(&thread, -INFINITE_SCORE, INFINITE_SCORE);
+        int bound = quiescence(&thread, score - 1, score);
+        int ok = (bound >= score);
+        if (!ok) failures++;
+        printf("#%-2d %s stand pat %d, score %d, null window below it %d\n", i + 1, ok ? "ok  " : "FAIL", standPat,
+               score, bound);
+    }
+
+    // Delta pruning must fire where it cannot change the result.
+    int deltas = sizeof(DELTA_SUITE) / sizeof(DELTA_SUITE[0]);
+    for (int i = 0; i < deltas; i++) {
+        memset(&thread.board, 0, sizeof(thread.board));
+        if (parseFenRec(&thread.board, (char *)DELTA_SUITE[i]) != 0) {
+            printf("#%-2d FEN parsing failed: %s\n", count + i + 1, DELTA_SUITE[i]);
+            failures++;
+            continue;
+        }
+
+        int alpha = evaluateBitboard(&thread.board) + R_VALUE;
+        thread.deltaPrunes = 0;
+        int bound = quiescence(&thread, alpha, alpha + 1);
+        int ok = (thread.deltaPrunes > 0 && bound <= alpha);
+        if (!ok) failures++;
+        printf("#%-2d %s %llu captures delta pruned, %d at or below alpha %d\n", count + i + 1, ok ? "ok  " : "FAIL",
+               thread.deltaPrunes, bound, alpha);
+    }
+    count += deltas;
+
+    // A leaf has a legal move exactly when the generator finds one.
+    int leaves = sizeof(LEAF_SUITE) / sizeof(LEAF_SUITE[0]);
+    for (int i = 0; i < leaves; i++) {
+        memset(&thread.board, 0, sizeof(thread.board));
+        if (parseFenRec(&thread.board, (char *)LEAF_SUITE[i]) != 0) {
+            printf("#%-2d FEN parsing failed: %s\n", count + i + 1, LEAF_SUITE[i]);
+            failures++;
+            continue;
+        }
+
+        MoveList legal;
+        generateLegalMoves(&thread.board, &legal);
+        int found = hasLegalMove(&thread.board);
+        int ok = (found == (legal.count > 0));
+        if (!ok) failures++;
+        printf("#%-2d %s %d legal moves, any legal move %s\n", count + i + 1, ok ? "ok  " : "FAIL", legal.count,
+               found ? "yes" : "no");
+    }
+    count += leaves;
+
+    printf("\n%d/%d passed\n", count - failures, count);
+    return failures;
+}
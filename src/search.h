@@ -1,12 +1,78 @@
 #ifndef SEARCH
 #define SEARCH
 
+#include <stdatomic.h>
+
 #include "bitboard.h"
 #include "evaluate.h"
-#include <stdbool.h>
+#include "movepick.h"
+#include "timeman.h"
+
+// Scores, from the point of view of the player to move. Being mated in n plies from the root
+// scores -MATE_SCORE + n; anything beyond MATE_IN_MAX in absolute value is a mate.
+#define INFINITE_SCORE 32500
+#define MATE_SCORE 32000
+#define MATE_IN_MAX (MATE_SCORE - MAX_PLY)
+
+// Everything one search thread works on: its own copy of the root position and what it learns
+typedef struct searchThread {
+    struct board board;
+    Heuristics heuristics;
+    _Atomic unsigned long long nodes; // read by the main thread while the thread searches
+    int id; // 0 is the main thread, the one that started the search
+    int completedDepth; // deepest iteration finished
+    int best; // index in the root moves of the best move found
+    int bestScore;
+    unsigned long long deltaPrunes; // captures the quiescence search skipped by delta pruning
+} SearchThread;
+
+// What a search found
+typedef struct searchResult {
+    int best; // index in the root moves of the best move
+    int score; // of the best move, from the point of view of the player to move
+    int depth; // deepest iteration completed
+    unsigned long long nodes; // all threads together
+    long long time; // ms since the search started
+} SearchResult;
+
+// What bounds a search
+typedef struct searchLimits {
+    TimeControl time; // all zero for no time limit
+    int depth; // deepest iteration to search (0 for no limit)
+    int infinite; // go on after a mate was found, and past the point where the next iteration cannot finish
+    atomic_int *stop; // if not NULL, another thread ends the search by setting it
+    void (*report)(const SearchResult *result); // if not NULL, called after every completed iteration
+} SearchLimits;
+
+int negamax(SearchThread *thread, int depth, int alpha, int beta, int ply);
+int quiescence(SearchThread *thread, int alpha, int beta);
+int iterativeDeepening(Board board, const Move *rootMoves, int count, const SearchLimits *limits, SearchResult *result);
+
+// Checks the quiescence search on positions delta pruning could get wrong or must prune, and the
+// end-of-game test at the leaves; returns the number of failures
+int quiescenceSuite(void);
+
+// Delta pruning: the positional gain allowed to a capture on top of the material it takes, and
+// the extra allowance of a capture that promotes or brings a pawn to the rank before promotion
+#define DELTA_MARGIN (2 * P_VALUE)
+#define DELTA_PROMOTION (Q_VALUE - P_VALUE)
+
+// Half width of the first window around the previous iteration's score (half a pawn, in engine
+// units), from which depth on
+#define ASPIRATION_WINDOW (P_VALUE / 2)
+#define ASPIRATION_DEPTH 4
+
+// Selectivity: null-move pruning from NULL_MOVE_DEPTH on; late move reductions from LMR_DEPTH
+// on, for quiet moves after the first LMR_MOVES
+#define NULL_MOVE_DEPTH 3
+#define LMR_DEPTH 3
+#define LMR_MOVES 3
 
+// A single legal move is played at once, after a search this deep to give it a score
+#define FORCED_MOVE_DEPTH 4
 
-double minimax(Board board, int depth, double alpha, double beta, bool maximizingPlayer);
-double quiescence(Board board, double alpha, double beta);
+// Searches whose hard deadline is shorter than this (in ms) split the root moves between the
+// threads rather than run Lazy SMP, whose threads need a few iterations to help each other
+#define ROOT_SPLIT_MS 1000
 
 #endif
\ No newline at end of file
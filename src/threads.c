@@ -0,0 +1,105 @@
+/**
+ * @file threads.c
+ * @brief This file contains the pool of search threads: helper threads are created once and
+ * sleep until the search hands them a job, so starting a search costs no thread creation.
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+#include <unistd.h>
+
+#include "init.h"
+#include "threads.h"
+
+static SearchThread *threads = NULL; // search state of every thread, the calling one first
+static pthread_t handles[MAX_THREADS];
+static int count = 0;
+
+static pthread_mutex_t lock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t wake = PTHREAD_COND_INITIALIZER; // a job was posted, or the pool quits
+static pthread_cond_t done = PTHREAD_COND_INITIALIZER; // the last running helper finished
+static void (*job)(SearchThread *thread) = NULL;
+static unsigned int generation = 0; // counts the jobs posted
+static int running = 0; // helpers still busy with the current job
+static int quitting = 0;
+
+// @brief: helper thread body: waits for a job, runs it, reports back, and again.
+static void *helperLoop(void *argument) {
+    SearchThread *thread = argument;
+    unsigned int seen = 0;
+
+    pthread_mutex_lock(&lock);
+    while (1) {
+        while (generation == seen && !quitting) pthread_cond_wait(&wake, &lock);
+        if (quitting) break;
+        seen = generation;
+        pthread_mutex_unlock(&lock);
+
+        job(thread);
+
+        pthread_mutex_lock(&lock);
+        if (--running == 0) pthread_cond_signal(&done);
+    }
+    pthread_mutex_unlock(&lock);
+    return NULL;
+}
+
+// @brief: stops and joins the helper threads and frees the search states.
+static void stopPool(void) {
+    pthread_mutex_lock(&lock);
+    quitting = 1;
+    pthread_cond_broadcast(&wake);
+    pthread_mutex_unlock(&lock);
+    for (int i = 1; i < count; i++) pthread_join(handles[i], NULL);
+
+    quitting = 0;
+    free(threads);
+    threads = NULL;
+    count = 0;
+}
+
+int setThreadCount(int requested) {
+    if (count) stopPool();
+
+    if (requested <= 0) requested = (int)sysconf(_SC_NPROCESSORS_ONLN);
+    if (requested < 1) requested = 1;
+    if (requested > MAX_THREADS) requested = MAX_THREADS;
+
+    threads = calloc(requested, sizeof(SearchThread));
+    if (!threads) return 0;
+
+    // The calling thread is thread 0; helpers that cannot be created are simply left out.
+    generation = 0;
+    count = 1;
+    threads[0].id = 0;
+    while (count < requested) {
+        threads[count].id = count;
+        if (pthread_create(&handles[count], NULL, helperLoop, &threads[count]) != 0) break;
+        count++;
+    }
+    return count;
+}
+
+int threadCount(void) {
+    return count;
+}
+
+SearchThread *getThread(int id) {
+    return (id >= 0 && id < count) ? &threads[id] : NULL;
+}
+
+void startHelpers(void (*helperJob)(SearchThread *thread)) {
+    pthread_mutex_lock(&lock);
+    job = helperJob;
+    running = count - 1;
+    generation++;
+    pthread_cond_broadcast(&wake);
+    pthread_mutex_unlock(&lock);
+}
+
+void waitForHelpers(void) {
+    pthread_mutex_lock(&lock);
+    while (running > 0) pthread_cond_wait(&done, &lock);
+    pthread_mutex_unlock(&lock);
+}
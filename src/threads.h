@@ -0,0 +1,29 @@
+#ifndef THREADS
+#define THREADS
+
+#include "search.h"
+
+// Most search threads the pool runs, the calling thread included
+#define MAX_THREADS 64
+
+// Threads used unless set otherwise: 0 means one per processor
+#define DEFAULT_THREADS 0
+
+/*
+(Re)starts the pool with the given number of search threads, the calling thread counting as
+the first one. Returns the number actually running, which is smaller if the system refuses
+to create more (e.g. a WebAssembly build without threads runs the calling thread only).
+*/
+int setThreadCount(int count);
+int threadCount(void);
+
+// Search state of a thread (0 is the calling thread)
+SearchThread *getThread(int id);
+
+// Runs job on every helper thread (1 ... threadCount() - 1) and returns at once
+void startHelpers(void (*job)(SearchThread *thread));
+
+// Waits until the jobs started by startHelpers returned
+void waitForHelpers(void);
+
+#endif
@@ -0,0 +1,61 @@
+/**
+ * @file timeman.c
+ * @brief This file contains the time manager, which turns the time control of a search (the
+ * clock, increment and moves to go, or a fixed time per move) into a soft deadline, past which
+ * no new iteration starts, and a hard one, at which the search is aborted.
+ */
+
+#include "timeman.h"
+#include "tools.h"
+
+// Share of the soft deadline (in %) to use, by how many iterations in a row the best move
+// stayed the same: a move that keeps changing gets more time, a settled one less.
+static const int STABILITY_SCALE[] = {130, 100, 85, 70, 60};
+#define STABILITY_LEVELS (int)(sizeof(STABILITY_SCALE) / sizeof(STABILITY_SCALE[0]))
+
+void initTimeManager(TimeManager *manager, const TimeControl *control) {
+    manager->start = timeMilliseconds();
+    manager->soft = 0;
+    manager->hard = 0;
+    manager->lastBest = -1;
+    manager->stability = 0;
+
+    if (control->moveTime > 0) {
+        // All of it may be used, but an iteration started past half of it rarely finishes.
+        manager->hard = control->moveTime - MOVE_OVERHEAD;
+        if (manager->hard < 1) manager->hard = 1;
+        manager->soft = manager->hard / 2;
+    } else if (control->time > 0) {
+        long long available = control->time - MOVE_OVERHEAD;
+        if (available < 1) available = 1;
+        int movesToGo = control->movesToGo > 0 ? control->movesToGo : DEFAULT_MOVES_TO_GO;
+
+        // An even share of the clock, plus most of the increment, which comes back after the move.
+        manager->soft = available / movesToGo + control->increment * 3 / 4;
+        // A difficult move may take a few shares, but never so many that the next moves starve.
+        manager->hard = manager->soft * 4;
+        long long most = movesToGo > 1 ? available * 3 / 4 : available;
+        if (manager->hard > most) manager->hard = most;
+        if (manager->soft > manager->hard) manager->soft = manager->hard;
+        if (manager->soft < 1) manager->soft = 1;
+    }
+}
+
+long long timeElapsed(const TimeManager *manager) {
+    return timeMilliseconds() - manager->start;
+}
+
+int timeOut(const TimeManager *manager) {
+    return manager->hard > 0 && timeElapsed(manager) >= manager->hard;
+}
+
+int timeStopIteration(TimeManager *manager, int best) {
+    if (best == manager->lastBest) {
+        if (manager->stability < STABILITY_LEVELS - 1) manager->stability++;
+    } else {
+        manager->lastBest = best;
+        manager->stability = 0;
+    }
+    if (manager->soft <= 0) return 0;
+    return timeElapsed(manager) >= manager->soft * STABILITY_SCALE[manager->stability] / 100;
+}
@@ -0,0 +1,46 @@
+#ifndef TIMEMAN
+#define TIMEMAN
+
+// How often (in nodes) the search looks at the clock: about every millisecond
+#define NODES_PER_CLOCK_CHECK 1024
+
+// Time (in ms) kept back from every budget for setting up the board and answering
+#define MOVE_OVERHEAD 50
+
+// Moves the rest of the clock is shared between when the time control does not say
+#define DEFAULT_MOVES_TO_GO 30
+
+// Time control of a search, as UCI gives it (all times in ms, 0 when not given)
+typedef struct timeControl {
+    long long time; // left on the clock of the player to move
+    long long increment; // added to it after every move
+    int movesToGo; // moves until the clock is refilled
+    long long moveTime; // fixed time for this move, instead of the clock
+} TimeControl;
+
+/*
+Deadlines of a running search, in ms since its start (0 for none). Past the soft one no new
+iteration is started, scaled down while the best move stays the same from one iteration to
+the next and up when it changes; at the hard one the search is aborted.
+*/
+typedef struct timeManager {
+    long long start; // timeMilliseconds() when the search started
+    long long soft;
+    long long hard;
+    int lastBest; // best move of the last iteration (index in the root moves), -1 before the first
+    int stability; // iterations in a row lastBest stayed the best move
+} TimeManager;
+
+// Starts the clock of a search and computes its deadlines
+void initTimeManager(TimeManager *manager, const TimeControl *control);
+
+// Time since the search started, in ms
+long long timeElapsed(const TimeManager *manager);
+
+// Whether the hard deadline passed; cheap enough to call every NODES_PER_CLOCK_CHECK nodes
+int timeOut(const TimeManager *manager);
+
+// Called after every completed iteration with its best move; returns 1 if no new one should start
+int timeStopIteration(TimeManager *manager, int best);
+
+#endif
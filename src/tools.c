@@ -1,6 +1,7 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <time.h>
 
 #include "tools.h"
 #include "init.h"
@@ -80,3 +81,10 @@ void printBinary(unsigned long long num) {
     }
     printf("\n");
 }
+
+// @brief: returns a monotonic wall-clock time in milliseconds, for measuring elapsed time.
+long long timeMilliseconds(void) {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (long long)now.tv_sec * 1000 + now.tv_nsec / 1000000;
+}
@@ -5,5 +5,6 @@
 void freeMoveSave(char **moveSave, int count);
 char **initMoveSave(const char *moves, int *returnSize);
 void printBinary(unsigned long long num);
+long long timeMilliseconds(void);
 
 #endif
\ No newline at end of file
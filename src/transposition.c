@@ -0,0 +1,141 @@
+/**
+ * @file transposition.c
+ * @brief This file contains the transposition table: a hash table, indexed by the position
+ * key, of earlier search results (score, bound, depth and best move), so that positions
+ * reached again through another move order are not searched from scratch. It is shared by
+ * all search threads without locking (see TTSlot).
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include <limits.h>
+#include <stdatomic.h>
+
+#include "init.h"
+#include "transposition.h"
+
+static TTBucket *table = NULL;
+static unsigned long long bucketMask = 0; // number of buckets - 1
+static unsigned char age = 0; // 6-bit counter, advanced by ttNewSearch
+
+// @brief: the bucket of a key (its low bits; the whole key is compared within the bucket).
+static TTBucket *bucketOf(unsigned long long key) {
+    return &table[key & bucketMask];
+}
+
+int ttResize(int megabytes) {
+    ttFree();
+    if (megabytes < 1) return 0;
+
+    // Largest power of two number of buckets that fits, halving whenever memory is short.
+    unsigned long long buckets = 1;
+    while (buckets * 2 * sizeof(TTBucket) <= (unsigned long long)megabytes << 20) buckets *= 2;
+    while (buckets && !(table = aligned_alloc(sizeof(TTBucket), buckets * sizeof(TTBucket)))) buckets /= 2;
+    if (!table) return 0;
+
+    bucketMask = buckets - 1;
+    ttClear();
+    return (int)((buckets * sizeof(TTBucket)) >> 20);
+}
+
+void ttClear(void) {
+    if (table) memset(table, 0, (bucketMask + 1) * sizeof(TTBucket));
+    age = 0;
+}
+
+void ttFree(void) {
+    free(table);
+    table = NULL;
+    bucketMask = 0;
+}
+
+int ttAllocated(void) {
+    return table != NULL;
+}
+
+void ttNewSearch(void) {
+    age = (age + 1) & 63;
+}
+
+// @brief: packs everything but the key into the 64 data bits of a slot.
+static unsigned long long packEntry(const TTEntry *entry) {
+    return (unsigned long long)entry->move |
+           ((unsigned long long)(unsigned short int)entry->score << 32) |
+           ((unsigned long long)entry->depth << 48) |
+           ((unsigned long long)entry->boundAge << 56);
+}
+
+// @brief: reads a slot; returns 0 if it is empty or was torn by a concurrent write.
+static int readSlot(TTSlot *slot, TTEntry *entry) {
+    unsigned long long data = atomic_load_explicit(&slot->data, memory_order_relaxed);
+    unsigned long long check = atomic_load_explicit(&slot->check, memory_order_relaxed);
+    if (!data) return 0;
+
+    entry->key = check ^ data;
+    entry->move = (Move)(data & 0xFFFFFFFFULL);
+    entry->score = (short int)(unsigned short int)(data >> 32);
+    entry->depth = (unsigned char)(data >> 48);
+    entry->boundAge = (unsigned char)(data >> 56);
+    return 1;
+}
+
+int ttProbe(unsigned long long key, TTEntry *entry) {
+    if (!table) return 0;
+
+    TTBucket *bucket = bucketOf(key);
+    for (int i = 0; i < TT_BUCKET_SIZE; i++) {
+        if (readSlot(&bucket->slots[i], entry) && entry->key == key) return 1;
+    }
+    return 0;
+}
+
+/*
+@brief: stores a search result. The position's own entry is updated if it has one; otherwise
+the entry replaced is the least valuable of the bucket, i.e. the shallowest one, counting
+entries of earlier searches as shallower the older they are.
+*/
+void ttStore(unsigned long long key, Move move, int score, int depth, int bound) {
+    if (!table) return;
+
+    TTBucket *bucket = bucketOf(key);
+    TTSlot *replace = &bucket->slots[0];
+    TTEntry old, entry;
+    int found = 0, lowest = 1 << 30;
+    for (int i = 0; i < TT_BUCKET_SIZE; i++) {
+        if (!readSlot(&bucket->slots[i], &entry)) {
+            replace = &bucket->slots[i];
+            break;
+        }
+        if (entry.key == key) {
+            replace = &bucket->slots[i];
+            old = entry;
+            found = 1;
+            break;
+        }
+        int value = entry.depth - 8 * ((age - TT_AGE(&entry)) & 63);
+        if (value < lowest) {
+            lowest = value;
+            replace = &bucket->slots[i];
+        }
+    }
+
+    if (found) {
+        // A deeper result of the same position from this search is worth more than a shallow bound.
+        if (TT_AGE(&old) == age && old.depth > depth && bound != TT_EXACT) return;
+        // Keep the best move of the earlier search when this one found none.
+        if (move == NO_MOVE) move = old.move;
+    }
+
+    // Search scores fit in a short int.
+    if (score > SHRT_MAX) score = SHRT_MAX;
+    if (score < -SHRT_MAX) score = -SHRT_MAX;
+
+    entry.move = move;
+    entry.score = (short int)score;
+    entry.depth = (unsigned char)(depth > 255 ? 255 : depth);
+    entry.boundAge = (unsigned char)((age << 2) | bound);
+
+    unsigned long long data = packEntry(&entry);
+    atomic_store_explicit(&replace->check, key ^ data, memory_order_relaxed);
+    atomic_store_explicit(&replace->data, data, memory_order_relaxed);
+}
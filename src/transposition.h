@@ -0,0 +1,59 @@
+#ifndef TRANSPOSITION
+#define TRANSPOSITION
+
+#include "init.h"
+#include "move.h"
+
+// Size of the table unless set otherwise
+#define TT_DEFAULT_MB 16
+
+// What the stored score says about the real one
+#define TT_EXACT 1
+#define TT_LOWER 2 // the score is a lower bound (the search failed high)
+#define TT_UPPER 3 // the score is an upper bound (the search failed low)
+
+// One search result, as read from or written to the table
+typedef struct ttEntry {
+    unsigned long long key; // full position key, to tell apart positions sharing a bucket
+    Move move; // best move found, or NO_MOVE
+    short int score; // from the point of view of the player to move, mates counted from here
+    unsigned char depth;
+    unsigned char boundAge; // bound type in the low 2 bits, search age in the upper 6
+} TTEntry;
+
+#define TT_BOUND(entry) ((entry)->boundAge & 3)
+#define TT_AGE(entry) ((entry)->boundAge >> 2)
+
+/*
+An entry as kept in the table, 16 bytes so that a bucket fills a cache line. The search threads
+read and write entries without locks: data packs move, score, depth and bound, and check holds
+key ^ data, so an entry torn by two threads writing at once no longer matches its key and is
+simply missed.
+*/
+typedef struct ttSlot {
+    _Atomic unsigned long long check;
+    _Atomic unsigned long long data;
+} TTSlot;
+
+#define TT_BUCKET_SIZE 4
+
+// Entries that share an index, probed and replaced together
+typedef struct ttBucket {
+    TTSlot slots[TT_BUCKET_SIZE];
+} TTBucket;
+
+// Allocates the table (power-of-two number of buckets, at most the given size);
+// returns the size in MB actually allocated, 0 if no memory could be had
+int ttResize(int megabytes);
+void ttClear(void);
+void ttFree(void);
+int ttAllocated(void);
+
+// Starts a new search: entries of older searches become the first to be replaced
+void ttNewSearch(void);
+
+// Looks a position up; returns 1 and fills entry if it is stored
+int ttProbe(unsigned long long key, TTEntry *entry);
+void ttStore(unsigned long long key, Move move, int score, int depth, int bound);
+
+#endif
@@ -0,0 +1,64 @@
+/**
+ * @file zobrist.c
+ * @brief This file contains the Zobrist keys: random numbers for every piece on every square,
+ * the side to move, the castling rights and the en passant file, whose XOR identifies a
+ * position. makeMove keeps board->key up to date by XORing the keys that change, and
+ * board->pawnKey, the XOR of the pawn keys alone, which indexes the pawn hash table.
+ */
+
+#include "init.h"
+#include "zobrist.h"
+
+unsigned long long pieceKeys[12][64];
+unsigned long long sideKey;
+unsigned long long castlingKeys[16];
+unsigned long long enPassantKeys[8];
+
+// @brief: xorshift64* generator with a fixed seed, so keys are the same in every run.
+static unsigned long long nextRandom(void) {
+    static unsigned long long state = 0x9E3779B97F4A7C15ULL;
+    state ^= state >> 12;
+    state ^= state << 25;
+    state ^= state >> 27;
+    return state * 0x2545F4914F6CDD1DULL;
+}
+
+void initZobrist(void) {
+    static int initialized = 0;
+    if (initialized) return;
+
+    for (int piece = 0; piece < 12; piece++) {
+        for (int square = 0; square < 64; square++) pieceKeys[piece][square] = nextRandom();
+    }
+    sideKey = nextRandom();
+    for (int rights = 0; rights < 16; rights++) castlingKeys[rights] = nextRandom();
+    for (int file = 0; file < 8; file++) enPassantKeys[file] = nextRandom();
+    initialized = 1;
+}
+
+unsigned long long computeKey(Board board) {
+    unsigned long long key = 0ULL;
+    for (int piece = 0; piece < 12; piece++) {
+        unsigned long long pieces = board->bitboards[piece];
+        while (pieces) {
+            key ^= pieceKeys[piece][__builtin_ctzll(pieces)];
+            pieces &= pieces - 1;
+        }
+    }
+    if (board->toMove == 'b') key ^= sideKey;
+    key ^= castlingKeys[board->castling & CASTLE_ALL];
+    if (board->pass != NO_EN_PASSANT) key ^= enPassantKeys[FILE_OF(board->pass)];
+    return key;
+}
+
+unsigned long long computePawnKey(Board board) {
+    unsigned long long key = 0ULL;
+    for (int piece = WHITE_PAWNS; piece <= BLACK_PAWNS; piece += BLACK_PAWNS - WHITE_PAWNS) {
+        unsigned long long pieces = board->bitboards[piece];
+        while (pieces) {
+            key ^= pieceKeys[piece][__builtin_ctzll(pieces)];
+            pieces &= pieces - 1;
+        }
+    }
+    return key;
+}
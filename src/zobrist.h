@@ -0,0 +1,21 @@
+#ifndef ZOBRIST
+#define ZOBRIST
+
+#include "init.h"
+
+// Random keys XORed together into the 64-bit position key (board->key)
+extern unsigned long long pieceKeys[12][64];
+extern unsigned long long sideKey; // present when black is to move
+extern unsigned long long castlingKeys[16]; // one per combination of CASTLE_* bits
+extern unsigned long long enPassantKeys[8]; // one per file of the en passant square
+
+// Fills the keys above (always the same ones); cheap to call again
+void initZobrist(void);
+
+// Computes the key of a position from scratch
+unsigned long long computeKey(Board board);
+
+// Computes the key of the pawns of a position (their piece keys only) from scratch
+unsigned long long computePawnKey(Board board);
+
+#endif